@@ -0,0 +1,5 @@
+/* : : generated from src/lib/libast/features/ndbm by iffe version 2024-12-23 : : */
+#ifndef _def_ndbm_ast
+#define _def_ndbm_ast	1
+#define _sys_types	1	/* #include <sys/types.h> ok */
+#endif
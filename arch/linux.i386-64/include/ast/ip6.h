@@ -0,0 +1,30 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2012 AT&T Intellectual Property          *
+*          Copyright (c) 2020-2022 Contributors to ksh 93u+m           *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                  Martijn Dekker <martijn@inlv.org>                   *
+*                                                                      *
+***********************************************************************/
+
+#ifndef _IP6_H
+#define _IP6_H		1
+
+#define IP6ADDR		16
+#define IP6BITS		IP6ADDR
+#define IP6PREFIX	(IP6ADDR+1)
+
+extern char*	fmtip6(const unsigned char*, int);
+extern int	strtoip6(const char*, char**, unsigned char*, unsigned char*);
+
+#endif
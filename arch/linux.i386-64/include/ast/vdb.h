@@ -0,0 +1,42 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2011 AT&T Intellectual Property          *
+*          Copyright (c) 2020-2022 Contributors to ksh 93u+m           *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                  Martijn Dekker <martijn@inlv.org>                   *
+*                                                                      *
+***********************************************************************/
+/*
+ * Glenn Fowler
+ * AT&T Research
+ *
+ * virtual db file directory entry constants
+ */
+
+#ifndef VDB_MAGIC
+
+#define VDB_MAGIC	"vdb"
+
+#define VDB_DIRECTORY	"DIRECTORY"
+#define VDB_UNION	"UNION"
+#define VDB_DATE	"DATE"
+#define VDB_MODE	"MODE"
+
+#define VDB_DELIMITER	';'
+#define VDB_IGNORE	'_'
+#define VDB_FIXED	10
+#define VDB_LENGTH	((int)sizeof(VDB_DIRECTORY)+2*(VDB_FIXED+1))
+#define VDB_OFFSET	((int)sizeof(VDB_DIRECTORY))
+#define VDB_SIZE	(VDB_OFFSET+VDB_FIXED+1)
+
+#endif
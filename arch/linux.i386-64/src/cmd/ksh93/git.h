@@ -0,0 +1,2 @@
+/* generated by ksh93/Mamfile using git version 2.39.5 */
+#define git_commit   "bf8f435f"
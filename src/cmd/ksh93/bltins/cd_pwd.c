@@ -229,7 +229,11 @@ success:
 		while(--len>0 && dir[len]=='/')
 			dir[len] = 0;
 		nv_putval(pwdnod,dir,NV_RDONLY);
-		nv_onattr(pwdnod,NV_EXPORT);
+		if(!nv_isattr(pwdnod,NV_EXPORT))
+		{
+			nv_onattr(pwdnod,NV_EXPORT);
+			env_change();
+		}
 		sh.pwd = sh_strdup(dir);
 	}
 	else
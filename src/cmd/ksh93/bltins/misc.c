@@ -46,6 +46,7 @@
 #include	"history.h"
 #include	"builtins.h"
 #include	"jobs.h"
+#include	<fcin.h>
 
 #include	<math.h>
 #include	"FEATURE/locale"
@@ -67,6 +68,7 @@ static void     noexport(Namval_t* np, void *data)
 	if(sh.subshell && !sh.subshare)
 		sh_assignok(np,0);
 	nv_offattr(np,NV_EXPORT);
+	env_change();
 }
 
 /*
@@ -325,7 +327,8 @@ int    b_dot_cmd(int n,char *argv[],Shbltin_t *context)
 		else
 		{
 			buffer = sh_malloc(IOBSIZE+1);
-			iop = sfnew(NULL,buffer,IOBSIZE,fd,SFIO_READ);
+			iop = sh_tcacheopen(sfnew(NULL,buffer,IOBSIZE,fd,SFIO_READ),filename);
+			fcmmap(iop);
 			sh_offstate(SH_NOFORK);
 			sh_eval(iop,sh_isstate(SH_PROFILE)?SH_FUNEVAL:0);
 		}
@@ -412,9 +415,22 @@ int    b_shift(int n, char *argv[], Shbltin_t *context)
 
 int    b_wait(int n,char *argv[],Shbltin_t *context)
 {
+	Namval_t	*np = NULL;
+	pid_t		pid;
+	int		next = 0;
 	NOT_USED(context);
 	while((n = optget(argv,sh_optwait))) switch(n)
 	{
+		case 'n':
+			next = 1;
+			break;
+		case 'p':
+			if(!(np = nv_open(opt_info.arg,sh.var_tree,NV_VARNAME|NV_NOARRAY)))
+			{
+				errormsg(SH_DICT,ERROR_exit(2),e_create,opt_info.arg);
+				UNREACHABLE();
+			}
+			break;
 		case ':':
 			errormsg(SH_DICT,2, "%s", opt_info.arg);
 			break;
@@ -428,7 +444,17 @@ int    b_wait(int n,char *argv[],Shbltin_t *context)
 		UNREACHABLE();
 	}
 	argv += opt_info.index;
-	job_bwait(argv);
+	if(next)
+	{
+		if(np)
+			_nv_unset(np,0);
+		if((pid = job_waitnext(argv)) && np)
+			nv_putval(np,fmtint(pid,1),0);
+	}
+	else
+		job_bwait(argv);
+	if(np)
+		nv_close(np);
 	return sh.exitval;
 }
 
@@ -348,7 +348,11 @@ int sh_readline(char **names, volatile int fd, int flags, ssize_t size, Sflong_t
 	}
 	was_write = (sfset(iop,SFIO_WRITE,0)&SFIO_WRITE)!=0;
 	if(fd==0)
-		was_share = (sfset(iop,SFIO_SHARE,sh.redir0!=2)&SFIO_SHARE)!=0;
+	{
+		/* in a 'while read' loop that no other process can read from, read ahead on a pipe */
+		int share = sh.redir0!=2 && !(sh.readahead && (sh.fdstatus[0]&(IONOSEEK|IOTTY))==IONOSEEK && sh.infd!=0);
+		was_share = (sfset(iop,SFIO_SHARE,share)&SFIO_SHARE)!=0;
+	}
 	if(timeout || (sh.fdstatus[fd]&(IOTTY|IONOSEEK)))
 	{
 		sh_pushcontext(&buff,1);
@@ -853,3 +857,218 @@ done:
 		siglongjmp(*sh.jmplist,jmpval);
 	return jmpval;
 }
+
+
+/*
+ * mapfile [-t] [-d delim] [-n count] [-O origin] [-s count] [-u fd] [-C callback [-c quantum]] [array]
+ */
+
+typedef struct _mapfile_
+{
+	Namval_t	*np;
+	char		*callback;
+	void		*stkptr;
+	int		offset;
+	Sflong_t	quantum;
+	Sflong_t	skip;
+	Sflong_t	nrec;
+	Sflong_t	origin;
+	Sflong_t	index;
+} Mapfile_t;
+
+/*
+ * true if the callback is to be run before assigning the next record
+ */
+#define mapcall(mp)	((mp)->callback && (mp)->nrec >= (mp)->skip && ((mp)->index-(mp)->origin+1) % (mp)->quantum == 0)
+
+/*
+ * assign record <rec> to the next array element
+ * if mapcall() is true, <rec> must be at the stack offset saved in <mp>
+ */
+static void mapput(Mapfile_t *mp, char *rec)
+{
+	if(mp->nrec++ < mp->skip)
+		return;
+	if(mapcall(mp))
+	{
+		char	*cp;
+		rec = stkfreeze(sh.stk,0);
+		sfprintf(sh.stk,"%s %lld ",mp->callback,mp->index);
+		if((cp = sh_fmtq(rec))==rec)
+			sfputr(sh.stk,rec,0);
+		sh_trap(stkptr(sh.stk,0),0);
+		nv_putsub(mp->np,NULL,(long)mp->index++|ARRAY_FILL|ARRAY_ADD);
+		nv_putval(mp->np,rec,0);
+		stkset(sh.stk,mp->stkptr,mp->offset);
+		return;
+	}
+	nv_putsub(mp->np,NULL,(long)mp->index++|ARRAY_FILL|ARRAY_ADD);
+	nv_putval(mp->np,rec,0);
+}
+
+/*
+ * Unless a record count is given, all input up to end of file is consumed,
+ * so the records are split directly in the stream buffer a window at a time
+ * with memchr(3); only records that span windows are copied to the stack.
+ */
+int	b_mapfile(int argc,char *argv[], Shbltin_t *context)
+{
+	Mapfile_t	map;
+	Sfio_t		*iop;
+	char		*name = "MAPFILE";
+	char		*base, *end, *cp, *ep;
+	ssize_t		len;
+	Sflong_t	count = 0;
+	int		r, c, fd = 0, delim = '\n', trim = 0, append = 0, share = 0;
+	NOT_USED(argc);
+	NOT_USED(context);
+	memset(&map,0,sizeof(map));
+	map.quantum = 5000;
+	while((r = optget(argv,sh_optmapfile))) switch(r)
+	{
+	    case 'C':
+		map.callback = opt_info.arg;
+		break;
+	    case 'c':
+		if((map.quantum = opt_info.num) <= 0)
+		{
+			errormsg(SH_DICT,2,"%s: invalid callback quantum",opt_info.arg);
+			error_info.errors++;
+		}
+		break;
+	    case 'd':
+		delim = *(unsigned char*)opt_info.arg;
+		break;
+	    case 'n':
+		count = opt_info.num;
+		break;
+	    case 'O':
+		map.origin = opt_info.num;
+		append = 1;
+		break;
+	    case 's':
+		map.skip = opt_info.num;
+		break;
+	    case 't':
+		trim = 1;
+		break;
+	    case 'u':
+		fd = (int)strtol(opt_info.arg,&opt_info.arg,10);
+		if(*opt_info.arg || !sh_iovalidfd(fd) || sh_inuse(fd))
+			fd = -1;
+		break;
+	    case ':':
+		errormsg(SH_DICT,2, "%s", opt_info.arg);
+		break;
+	    case '?':
+		errormsg(SH_DICT,ERROR_usage(2), "%s", opt_info.arg);
+		UNREACHABLE();
+	}
+	argv += opt_info.index;
+	if(error_info.errors || argv[0] && argv[1] || count<0 || map.skip<0 || map.origin<0 || map.origin>=ARRAY_MAX)
+	{
+		errormsg(SH_DICT,ERROR_usage(2), "%s", optusage(NULL));
+		UNREACHABLE();
+	}
+	if(argv[0])
+		name = argv[0];
+	if(fd>=0 && (!((r=sh.fdstatus[fd])&IOREAD) || !(r&(IOSEEK|IONOSEEK))))
+		r = sh_iocheckfd(fd);
+	if(fd<0 || !(r&IOREAD))
+	{
+		errormsg(SH_DICT,ERROR_system(1),e_file+4);
+		UNREACHABLE();
+	}
+	if(!(iop=sh.sftable[fd]) && !(iop=sh_iostream(fd)))
+		return 1;
+	map.np = nv_open(name,sh.var_tree,NV_ARRAY|NV_VARNAME);
+	if(nv_isattr(map.np,NV_RDONLY))
+	{
+		errormsg(SH_DICT,ERROR_exit(1),e_readonly,nv_name(map.np));
+		UNREACHABLE();
+	}
+	if(nv_aindex(map.np) < 0)
+	{
+		errormsg(SH_DICT,ERROR_exit(1),"%s: not an indexed array",nv_name(map.np));
+		UNREACHABLE();
+	}
+	if(!append)
+	{
+		/* leave an empty indexed array if there is no input */
+		nv_unset(map.np);
+		nv_onattr(map.np,NV_ARRAY);
+	}
+	map.index = map.origin;
+	map.stkptr = stkfreeze(sh.stk,0);
+	map.offset = stktell(sh.stk);
+	sfclrerr(iop);
+	if(count)
+	{
+		/* stop exactly after the last record read */
+		while(map.nrec < count + map.skip)
+		{
+			if(cp = sfgetr(iop,delim,0))
+				len = sfvalue(iop) - trim;
+			else if(cp = sfgetr(iop,delim,-1))
+				len = sfvalue(iop);
+			else
+				break;
+			sfwrite(sh.stk,cp,len);
+			sfputc(sh.stk,0);
+			mapput(&map,stkptr(sh.stk,map.offset));
+			stkseek(sh.stk,map.offset);
+		}
+		goto done;
+	}
+	/* the rest of the input is read anyway, so there is no need to share it */
+	share = sfset(iop,SFIO_SHARE,0) & SFIO_SHARE;
+	while(base = sfreserve(iop,SFIO_UNBOUND,SFIO_LOCKR))
+	{
+		end = base + sfvalue(iop);
+		for(cp = base; ep = memchr(cp,delim,end-cp); cp = ep+1)
+		{
+			len = ep - cp + !trim;
+			if(stktell(sh.stk) > map.offset || mapcall(&map) || !trim && ep+1==end)
+			{
+				sfwrite(sh.stk,cp,len);
+				sfputc(sh.stk,0);
+				if(mapcall(&map))
+				{
+					/* release the buffer, as the callback may use the stream */
+					sfread(iop,base,ep+1-base);
+					base = 0;
+				}
+				mapput(&map,stkptr(sh.stk,map.offset));
+				stkseek(sh.stk,map.offset);
+				if(!base)
+					break;
+			}
+			else
+			{
+				c = cp[len];
+				cp[len] = 0;
+				mapput(&map,cp);
+				cp[len] = c;
+			}
+		}
+		if(base)
+		{
+			/* keep the start of a record that continues in the next window */
+			if(cp < end)
+				sfwrite(sh.stk,cp,end-cp);
+			sfread(iop,base,end-base);
+		}
+	}
+	if(stktell(sh.stk) > map.offset)
+	{
+		/* last record not terminated by the delimiter */
+		sfputc(sh.stk,0);
+		mapput(&map,stkptr(sh.stk,map.offset));
+	}
+	if(share)
+		sfset(iop,SFIO_SHARE,1);
+done:
+	stkset(sh.stk,map.stkptr,map.offset);
+	nv_close(map.np);
+	return 0;
+}
@@ -1619,8 +1619,11 @@ static void print_scan(Sfio_t *file, int flag, Dt_t *root, int option,struct tda
 	namec = nv_scan(root, nullscan, tp, tp->scanmask, flag&~NV_IARRAY);
 	argv = tp->argnam  = stkalloc(sh.stk,(namec+1)*sizeof(char*));
 	namec = nv_scan(root, pushname, tp, tp->scanmask, flag&~NV_IARRAY);
+	/* hashed dictionaries such as the alias and tracked alias trees are only sorted here */
 	if(mbcoll())
 		strsort(argv,namec,strcoll);
+	else if(!(dtmethod(root,NULL)->type&DT_ORDERED))
+		strsort(argv,namec,strcmp);
 	if(namec==0 && sh.namespace && nv_dict(sh.namespace)==root)
 	{
 		sfnputc(file,'\t',tp->indent);
@@ -115,6 +115,7 @@ const struct shtable3 shtab_builtins[] =
 	"printf",	NV_BLTIN|BLT_ENV,		bltin(printf),
 	"pwd",		NV_BLTIN|BLT_ENV,		bltin(pwd),
 	"read",		NV_BLTIN|BLT_ENV,		bltin(read),
+	"mapfile",	NV_BLTIN|BLT_ENV,		bltin(mapfile),
 	"sleep",	NV_BLTIN,			bltin(sleep),
 	"alarm",	NV_BLTIN|BLT_ENV,		bltin(alarm),
 	"times",	NV_BLTIN|BLT_ENV|BLT_SPC,	bltin(times),
@@ -245,6 +246,10 @@ const char sh_set[] =
 			"environment's \bDEBUG\b trap action. Function scopes "
 			"inherit the \b-x\b option's state.]"
 		"[+glob?Opposite of \b-f\b.]"
+		"[+globcache?Pathname expansion keeps the contents of each "
+			"directory it reads in memory and reuses them while "
+			"the directory's modification and change times stay "
+			"the same.]"
 #if SHOPT_GLOBCASEDET
 		"[+globcasedetect?Pathname expansion and file name completion "
 			"automatically become case-insensitive on file systems "
@@ -299,6 +304,13 @@ const char sh_set[] =
 			"be zero if all commands return zero exit status.]"
 		"[+posix?Enable full POSIX standard compliance mode.]"
 		"[+privileged?Equivalent to \b-p\b.]"
+#if SHOPT_STATS
+		"[+profile?Record the number of executions, the elapsed, user "
+			"and system time and the number of processes created "
+			"for each script line and function. A report is written "
+			"to standard error, or to the file named by "
+			"\bKSH_PROFILEFILE\b, when the shell exits.]"
+#endif
 		"[+showme?Simple commands preceded by a \b;\b will be traced "
 			"as if \b-x\b were enabled but not executed.]"
 		"[+trackall?Equivalent to \b-h\b.]"
@@ -1197,6 +1209,48 @@ const char sh_optlet[]	=
 "[+SEE ALSO?\bexpr\b(1), \btest\b(1), \bksh\b(1)]"
 ;
 
+const char sh_optmapfile[] =
+"[-1c?\n@(#)$Id: mapfile (ksh 93u+m) 2026-10-17 $\n]"
+"[--catalog?" SH_DICT "]"
+"[+NAME?mapfile - read lines into an indexed array]"
+"[+DESCRIPTION?\bmapfile\b reads lines from standard input and assigns "
+	"each of them to an element of the indexed array \aarray\a, starting "
+	"at index 0. If \aarray\a is not specified, the array \bMAPFILE\b "
+	"is used. Unless \b-O\b is specified, \aarray\a is unset first, "
+	"so it is left as an empty indexed array if there is no input. It is "
+	"an error for \aarray\a to be an associative array.]"
+"[+?The lines are not split into fields and backslashes are not special. "
+	"When all the input up to end of file is read, it is split into "
+	"lines as it is buffered, which is much faster than reading it line "
+	"by line with \bread\b. An input line that is not terminated by the "
+	"delimiter at end of file is also stored.]"
+"[C]:[callback?Evaluate \acallback\a before every \aquantum\ath line is "
+	"assigned. The index of the array element to be assigned and the "
+	"line itself, quoted, are appended to \acallback\a as arguments.]"
+"[c]#[quantum:=5000?Specify the number of lines between calls to "
+	"\acallback\a.]"
+"[d]:[delim?Read lines terminated by the first character of \adelim\a "
+	"instead of a newline. If \adelim\a is the empty string, lines are "
+	"terminated by a null byte.]"
+"[n]#[count?Read at most \acount\a lines. If \acount\a is 0, read all "
+	"lines. When a count is given, no input beyond the last line read "
+	"is consumed.]"
+"[O]#[origin?Assign the first line to index \aorigin\a and do not unset "
+	"\aarray\a first.]"
+"[s]#[count?Discard the first \acount\a lines read.]"
+"[t?Remove the delimiter from each line.]"
+"[u]:[fd:=0?Read from file descriptor number \afd\a instead of standard "
+	"input.]"
+"\n"
+"\n[array]\n"
+"\n"
+"[+EXIT STATUS?]{"
+	"[+0?Successful completion.]"
+	"[+>0?An error occurred.]"
+"}"
+"[+SEE ALSO?\bread\b(1), \btypeset\b(1)]"
+;
+
 const char sh_optprint[] =
 "[-1c?\n@(#)$Id: print (ksh 93u+m) 2022-09-26 $\n]"
 "[--catalog?" SH_DICT "]"
@@ -2099,7 +2153,7 @@ const char sh_optunalias[] =
 ;
 
 const char sh_optwait[]	=
-"[-1c?\n@(#)$Id: wait (AT&T Research) 1999-06-17 $\n]"
+"[-1c?\n@(#)$Id: wait (ksh 93u+m) 2026-10-17 $\n]"
 "[--catalog?" SH_DICT "]"
 "[+NAME?wait - wait for process or job completion]"
 "[+DESCRIPTION?\bwait\b with no operands, waits until all jobs "
@@ -2110,6 +2164,18 @@ _JOB_
 "[+?If one or more \ajob\a operands is a process ID or process group ID "
 	"not known by the current shell environment, \bwait\b treats each "
 	"of them as if it were a process that exited with status 127.]"
+"[+?The number of background jobs that can run at the same time can be "
+	"limited by assigning a number to the \bJOBMAX\b variable. When this "
+	"limit is reached, the shell waits for a job to complete before "
+	"starting a new one.]"
+"[n?Wait for only one job to complete: the next of the \ajob\as given, or "
+	"the next job known to the invoking shell if none are given. "
+	"Jobs that have already completed but have not yet been waited "
+	"for are reported first, the oldest first. The exit status is that "
+	"of the job, or 127 if there is no job to wait for.]"
+"[p]:[name?When used with \b-n\b, assign the process ID of the job "
+	"that completed to the variable \aname\a. If no job completed, "
+	"\aname\a is unset.]"
 "\n"
 "\n[job ...]\n"
 "\n"
@@ -46,6 +46,7 @@ const Shtable_t shtab_options[] =
 	"noexec",			SH_NOEXEC,
 	"functrace",			SH_FUNCTRACE,
 	"noglob",			SH_NOGLOB,
+	"globcache",			SH_GLOBCACHE,
 #if SHOPT_GLOBCASEDET || !defined(SHOPT_GLOBCASEDET)
 	"globcasedetect",		SH_GLOBCASEDET,
 #endif
@@ -76,6 +77,9 @@ const Shtable_t shtab_options[] =
 	"pipefail",			SH_PIPEFAIL,
 	"posix",			SH_POSIX,
 	"privileged",			SH_PRIVILEGED,
+#if SHOPT_STATS
+	"profile",			SH_CMDPROFILE,
+#endif
 	"rc",				SH_RC|SH_COMMANDLINE,
 	"restricted",			SH_RESTRICTED,
 	"showme",			SH_SHOWME,
@@ -101,6 +101,7 @@ const struct shtable2 shtab_variables[] =
 	".sh.pid",	NV_PID|NV_NOFREE,		NULL,
 	".sh.ppid",	NV_PID|NV_NOFREE,		NULL,
 	".sh.tilde",	0,				NULL,
+	".sh.regcache",	NV_NOFREE|NV_INTEGER,		NULL,
 	"SHLVL",	NV_INTEGER|NV_NOFREE|NV_EXPORT,	NULL,
 	"SRANDOM",	NV_NOFREE|NV_INTEGER|NV_UNSIGN,	NULL,
 	"",	0,					NULL
@@ -122,9 +123,12 @@ const Shtable_t shtab_stats[] =
 	"nv_opens",		STAT_NVOPEN,
 	"pathsearch",		STAT_PATHS,
 	"posixfuncall",		STAT_SVFUNCT,
+	"re_cachehits",		STAT_REHITS,
+	"re_compiles",		STAT_RECOMP,
 	"simplecmds",		STAT_SCMDS,
 	"spawns",		STAT_SPAWN,
-	"subshell",		STAT_SUBSHELL
+	"subshell",		STAT_SUBSHELL,
+	"subshell_forks",	STAT_SUBFORK
 };
 #endif /* SHOPT_STATS */
 
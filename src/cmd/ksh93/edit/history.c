@@ -62,8 +62,23 @@
 #   define _HIST_AUDIT
 #endif
 
+/*
+ * To speed up searching, each command can have a signature with one bit set
+ * for each pair of adjacent bytes in it. A command can only contain a string
+ * if its signature has all the bits of the signature of that string, so
+ * hist_find() only needs to read the commands that pass this test.
+ */
+#define HIST_SIGBITS	256
+
+typedef struct Histsig
+{
+	off_t		offset;		/* offset of the command it was made for */
+	uint32_t	bits[HIST_SIGBITS/32];
+} Histsig_t;
+
 #define _HIST_PRIVATE \
 	off_t	histcnt;	/* offset into history file */\
+	Histsig_t *histsig;	/* search signatures, indexed like histcmds */\
 	off_t	histmarker;	/* offset of last command marker */ \
 	int	histflush;	/* set if flushed outside of hflush() */\
 	int	histmask;	/* power of two mask for histcnt */ \
@@ -276,6 +291,7 @@ retry:
 	sh.hist_ptr = hist_ptr = hp;
 	hp->histsize = maxlines;
 	hp->histmask = histmask;
+	hp->histsig = NULL;
 	hp->histfp= sfnew(NULL,hp->histbuff,HIST_BSIZE,fd,SFIO_READ|SFIO_WRITE|SFIO_APPENDWR|SFIO_SHARE);
 	memset((char*)hp->histcmds,0,sizeof(off_t)*(hp->histmask+1));
 	hp->histind = 1;
@@ -371,6 +387,7 @@ retry:
 void hist_close(History_t *hp)
 {
 	sfclose(hp->histfp);
+	free(hp->histsig);
 #if SHOPT_AUDIT
 	if(hp->auditfp)
 	{
@@ -481,6 +498,7 @@ static History_t* hist_trim(History_t *hp, int n)
 	}
 	hist_cancel(hist_new);
 	sfclose(hist_old->histfp);
+	free(hist_old->histsig);
 	free(hist_old);
 	return hist_ptr = hist_new;
 }
@@ -563,6 +581,9 @@ void hist_eof(History_t *hp)
 	off_t last = sfseek(hp->histfp,0,SEEK_END);
 	if(last < count)
 	{
+		/* the file was rewritten, so offsets no longer identify commands */
+		free(hp->histsig);
+		hp->histsig = NULL;
 		last = -1;
 		count = 2+HIST_MARKSZ;
 		oldind = hp->histind;
@@ -858,6 +879,44 @@ void hist_list(History_t *hp,Sfio_t *outfile, off_t offset,int last, char *nl)
 	return;
 }
 
+/*
+ * compute the signature <bits> of the <n> bytes at <cp>
+ */
+static void hist_sig(const unsigned char *cp, size_t n, uint32_t *bits)
+{
+	const unsigned char *ep = cp+n;
+	unsigned int b;
+	memset(bits,0,HIST_SIGBITS/8);
+	for(; cp+1 < ep; cp++)
+	{
+		b = (cp[0]*31u + cp[1]) & (HIST_SIGBITS-1);
+		bits[b>>5] |= 1u<<(b&31);
+	}
+}
+
+/*
+ * return 0 if command <n> cannot contain a string with signature <bits>
+ */
+static int hist_sigmatch(History_t *hp, int n, const uint32_t *bits)
+{
+	Histsig_t	*sp = &hp->histsig[hist_ind(hp,n)];
+	off_t		offset = hist_tell(hp,n);
+	char		*cp;
+	int		i;
+	if(sp->offset!=offset)
+	{
+		sfseek(hp->histfp,offset,SEEK_SET);
+		if(!(cp = sfgetr(hp->histfp,0,0)))
+			return 1;
+		hist_sig((unsigned char*)cp,sfvalue(hp->histfp)-1,sp->bits);
+		sp->offset = offset;
+	}
+	for(i = 0; i < HIST_SIGBITS/32; i++)
+		if((sp->bits[i] & bits[i]) != bits[i])
+			return 0;
+	return 1;
+}
+
 /*
  * find index for last line with given string
  * If flag==0 then line must begin with string
@@ -868,6 +927,8 @@ Histloc_t hist_find(History_t*hp,char *string,int index1,int flag,int direction)
 	int index2;
 	off_t offset;
 	int *coffset=0;
+	int last, usesig;
+	uint32_t bits[HIST_SIGBITS/32];
 	Histloc_t location;
 	location.hist_command = -1;
 	location.hist_char = 0;
@@ -899,14 +960,25 @@ Histloc_t hist_find(History_t*hp,char *string,int index1,int flag,int direction)
 	}
 	else if(index1 >= index2)
 		return location;
+	/* the current command may still be incomplete, so it has no signature */
+	last = hist_max(hp);
+	if(usesig = strlen(string) > 1)
+	{
+		if(!hp->histsig)
+			hp->histsig = sh_newof(0,Histsig_t,hp->histmask+1,0);
+		hist_sig((unsigned char*)string,strlen(string),bits);
+	}
 	while(index1!=index2)
 	{
 		direction>0?++index1:--index1;
-		offset = hist_tell(hp,index1);
-		if((location.hist_line=hist_match(hp,offset,string,coffset))>=0)
+		if(!usesig || index1>=last || hist_sigmatch(hp,index1,bits))
 		{
-			location.hist_command = index1;
-			return location;
+			offset = hist_tell(hp,index1);
+			if((location.hist_line=hist_match(hp,offset,string,coffset))>=0)
+			{
+				location.hist_command = index1;
+				return location;
+			}
 		}
 		/* allow a search to be aborted */
 		if(sh.trapnote & SH_SIGSET)
@@ -94,6 +94,7 @@ extern int b_eloop(int, char*[],Shbltin_t*);
 extern int b_hist(int, char*[],Shbltin_t*);
 extern int b_let(int, char*[],Shbltin_t*);
 extern int b_read(int, char*[],Shbltin_t*);
+extern int b_mapfile(int, char*[],Shbltin_t*);
 extern int b_ulimit(int, char*[],Shbltin_t*);
 extern int b_umask(int, char*[],Shbltin_t*);
 #if _cmd_universe
@@ -178,6 +179,7 @@ extern const char sh_optstop[];
 extern const char sh_optsuspend[];
 extern const char sh_optksh[];
 extern const char sh_optlet[];
+extern const char sh_optmapfile[];
 extern const char sh_optprint[];
 extern const char sh_optprintf[];
 extern const char sh_optpwd[];
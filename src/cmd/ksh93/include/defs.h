@@ -229,10 +229,15 @@ extern const char	e_scriptonly[];
 #   define	STAT_NVOPEN	8
 #   define	STAT_PATHS	9
 #   define	STAT_SVFUNCT	10
-#   define	STAT_SCMDS	11
-#   define	STAT_SPAWN	12
-#   define	STAT_SUBSHELL	13
+#   define	STAT_REHITS	11
+#   define	STAT_RECOMP	12
+#   define	STAT_SCMDS	13
+#   define	STAT_SPAWN	14
+#   define	STAT_SUBSHELL	15
+#   define	STAT_SUBFORK	16
     extern const Shtable_t shtab_stats[];
+    extern void		sh_profile(int);
+    extern void		sh_profdump(void);
 #   define sh_stats(x)	(sh.stats[(x)]++)
 #else
 #   define sh_stats(x)
@@ -32,6 +32,7 @@ typedef struct _fcin
 	unsigned char	*fclast;	/* pointer to end of input buffer */
 	unsigned char	*fcptr;		/* pointer to next input char */
 	unsigned char	fcchar;		/* saved character */
+	unsigned char	fcmmap;		/* buffer is a mapping of the file */
 	short		fclen;		/* last multibyte char len */
 	void (*fcfun)(Sfio_t*,const char*,int,void*);	/* advance function */
 	void		*context;	/* context pointer */
@@ -60,6 +61,7 @@ typedef struct _fcin
 extern int		fcfill(void);
 extern int		fcfopen(Sfio_t*);
 extern int		fcclose(void);
+extern int		fcmmap(Sfio_t*);
 void			fcnotify(void(*)(Sfio_t*,const char*,int,void*),void*);
 
 extern Fcin_t		_Fcin;		/* used by macros */
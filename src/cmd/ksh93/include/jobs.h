@@ -41,7 +41,9 @@
 struct process
 {
 	struct process *p_nxtjob;	/* next job structure */
+	struct process *p_prvjob;	/* previous job structure */
 	struct process *p_nxtproc;	/* next process in current job */
+	struct process *p_nxtpid;	/* next process in PID hash chain */
 	int		*p_exitval;	/* place to store the exitval */
 	pid_t		p_pid;		/* process ID */
 	pid_t		p_pgrp;		/* process group */
@@ -78,6 +80,10 @@ struct jobs
 	char		waitall;	/* wait for all jobs in pipe */
 	char		toclear;	/* job table needs clearing */
 	unsigned char	*freejobs;	/* free jobs numbers */
+	struct process	**jobtab;	/* jobs indexed by job number */
+	struct process	**pidtab;	/* processes hashed by process ID */
+	int		jobtabsize;	/* number of entries in jobtab */
+	int		pidtabsize;	/* number of entries in pidtab, a power of 2 */
 };
 
 /* flags for joblist */
@@ -117,6 +123,7 @@ extern const char	e_no_start[];
 
 extern void	job_clear(void);
 extern void	job_bwait(char**);
+extern pid_t	job_waitnext(char**);
 extern int	job_walk(Sfio_t*,int(*)(struct process*,int),int,char*[]);
 extern int	job_kill(struct process*,int);
 extern int	job_wait(pid_t);
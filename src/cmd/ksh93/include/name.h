@@ -148,6 +148,7 @@ extern Namfun_t 	*nv_cover(Namval_t*);
 extern Namarr_t 	*nv_arrayptr(Namval_t*);
 extern int		nv_arrayisset(Namval_t*, Namarr_t*);
 extern int		nv_arraysettype(Namval_t*, Namval_t*,const char*,int);
+extern void		*nv_arrayslot(Namval_t*, void**, size_t);
 extern int		nv_aimax(Namval_t*);
 extern int		nv_atypeindex(Namval_t*, const char*);
 extern void		nv_setlist(struct argnod*, int, Namval_t*);
@@ -138,6 +138,7 @@ typedef union Shnode_u Shnode_t;
 #define SH_RC		35
 #define SH_SHOWME	36
 #define SH_LETOCTAL	37
+#define SH_GLOBCACHE	38
 #if !_BLD_ksh || SHOPT_BRACEPAT
 #define SH_BRACEEXPAND	42
 #endif
@@ -153,6 +154,9 @@ typedef union Shnode_u Shnode_t;
 #define SH_MULTILINE	47
 #define SH_NOBACKSLCTRL	48
 #endif
+#if !_BLD_ksh || SHOPT_STATS
+#define SH_CMDPROFILE	49
+#endif
 #define SH_LOGIN_SHELL	67
 
 #if _BLD_ksh
@@ -338,6 +342,8 @@ struct Shell_s
 	char		instance;	/* in set_instance */
 	char		radixpoint;	/* current radix point ('.' or ',') */
 	char		redir0;		/* redirect of 0 */
+	char		readahead;	/* 'read' may buffer standard input freely (see sh/xec.c) */
+	char		discfun;	/* set once a discipline function has been defined */
 	char		intrace;	/* set when trace expands PS4 */
 	char		*readscript;	/* set before reading a script */
 	int		*inpipe;	/* input pipe pointer */
@@ -212,5 +212,7 @@ extern void			sh_funstaks(struct slnod*,int);
 extern Sfio_t 			*sh_subshell(Shnode_t*, volatile int, int);
 extern int			sh_tdump(Sfio_t*, const Shnode_t*);
 extern Shnode_t			*sh_trestore(Sfio_t*);
+extern Sfio_t			*sh_tcacheopen(Sfio_t*, const char*);
+extern void			sh_tcachedump(Sfio_t*, const Shnode_t*, int);
 
 #endif /* _SHNODES_H */
@@ -388,6 +388,10 @@ static void applyopts(Shopt_t newflags)
 		sh_onstate(SH_MONITOR);
 	else if(sh_isoption(SH_MONITOR) && !is_option(&newflags,SH_MONITOR))
 		sh_offstate(SH_MONITOR);
+#if SHOPT_STATS
+	if(is_option(&newflags,SH_CMDPROFILE) != sh_isoption(SH_CMDPROFILE))
+		sh_profile(is_option(&newflags,SH_CMDPROFILE)!=0);
+#endif
 	sh.options = newflags;
 }
 
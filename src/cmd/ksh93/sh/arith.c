@@ -58,6 +58,29 @@ static Namval_t FunNode =
 	"?",
 };
 
+/*
+ * Cache of expressions compiled by sh_strnum(), keyed by the expression text
+ * and by the mode and options that affect how it is compiled. The entries are
+ * compiled as by sh_arithcomp(), so variables are bound when they are used.
+ * Expressions that call user-defined math functions are not cached, so that
+ * redefining or unsetting a function needs no invalidation.
+ */
+#define ARITH_CACHE	64	/* must be a power of 2 */
+
+struct arithcache
+{
+	char		*expr;		/* copy of the expression text */
+	Arith_t		*ep;		/* compiled expression */
+	unsigned int	hash;		/* hash of expr */
+	int		key;		/* mode and options */
+	int		end;		/* offset of the first character not compiled */
+	int		busy;		/* number of running arith_exec() calls */
+	char		radix;		/* radix point */
+};
+
+static struct arithcache	arithcache[ARITH_CACHE];
+static char			arith_nocache;
+
 static Namval_t *scope(Namval_t *np,struct lval *lvalue,int assign)
 {
 	int	flag = lvalue->flag;
@@ -336,6 +359,7 @@ static Sfdouble_t arith(const char **ptr, struct lval *lvalue, int type, Sfdoubl
 				if(np=nv_search(stkptr(sh.stk,off),sh.fun_tree,0))
 				{
 					struct Ufunction *rp = np->nvalue;
+					arith_nocache = 1;
 					lvalue->nargs = -rp->argc;
 					lvalue->fun = (Math_f)np;
 					break;
@@ -564,6 +588,70 @@ static Sfdouble_t arith(const char **ptr, struct lval *lvalue, int type, Sfdoubl
 	return r;
 }
 
+/*
+ * Evaluate the arithmetic expression <str> like arith_strval(), but use the
+ * cache to avoid compiling it again
+ */
+static Sfdouble_t arith_cached(const char *str, char **last, int mode)
+{
+	struct arithcache	*cp;
+	unsigned int		hash = 0;
+	const unsigned char	*s;
+	char			*sp, *expr, *end;
+	int			key, offset;
+	Arith_t			*ep;
+	Sfdouble_t		d;
+	if(sh_isoption(SH_NOEXEC))
+		return arith_strval(str,last,arith,mode);
+	key = mode<<3 | (sh_isoption(SH_POSIX)!=0) | (sh_isoption(sh.bltinfun==b_let ? SH_LETOCTAL : SH_POSIX)!=0)<<1 | (mbwide()!=0)<<2;
+	for(s = (const unsigned char*)str; *s; s++)
+		hash = (hash<<5) + hash + *s;
+	cp = &arithcache[hash & (ARITH_CACHE-1)];
+	if(!(cp->ep && cp->hash==hash && cp->key==key && cp->radix==sh.radixpoint && strcmp(cp->expr,str)==0))
+	{
+		if(cp->busy)
+			return arith_strval(str,last,arith,mode);
+		if(offset = stktell(sh.stk))
+			sp = stkfreeze(sh.stk,1);
+		else
+			sp = stkptr(sh.stk,0);
+		expr = sh_strdup(str);
+		arith_nocache = 0;
+		if(!(ep = arith_compile(expr,&end,arith,ARITH_COMP|mode)) || arith_nocache)
+		{
+			/* let arith_strval() report the error or do the function call */
+			free(expr);
+			stkset(sh.stk,sp,offset);
+			return arith_strval(str,last,arith,mode);
+		}
+		if(cp->ep)
+		{
+			free(cp->expr);
+			free(cp->ep);
+		}
+		cp->ep = sh_malloc(sizeof(Arith_t)+ep->size);
+		memcpy(cp->ep,ep,sizeof(Arith_t)+ep->size);
+		cp->ep->code = (unsigned char*)(cp->ep+1);
+		cp->ep->emode = mode|ARITH_COMP;
+		cp->expr = expr;
+		cp->end = end - expr;
+		cp->hash = hash;
+		cp->key = key;
+		cp->radix = sh.radixpoint;
+		stkset(sh.stk,sp,offset);
+	}
+	*last = (char*)str + cp->end;
+	if(offset = stktell(sh.stk))
+		sp = stkfreeze(sh.stk,1);
+	else
+		sp = stkptr(sh.stk,0);
+	cp->busy++;
+	d = arith_exec(cp->ep);
+	cp->busy--;
+	stkset(sh.stk,sp,offset);
+	return d;
+}
+
 /*
  * convert number defined by string to a Sfdouble_t
  * ptr is set to the last character processed
@@ -603,7 +691,7 @@ Sfdouble_t sh_strnum(const char *str, char** ptr, int mode)
 			else
 			{
 				if(!last || *last!=sh.radixpoint || last[1]!=sh.radixpoint)
-					d = arith_strval(str,&last,arith,mode);
+					d = arith_cached(str,&last,mode);
 				if(!ptr && *last && mode>0)
 				{
 					errormsg(SH_DICT,ERROR_exit(1),e_lexbadchar,*last,str);
@@ -43,6 +43,21 @@
 #define NV_CHILD		NV_EXPORT
 #define ARRAY_CHILD		1
 #define ARRAY_NOFREE		2
+#define ARRAY_SLOTS		256	/* numeric values per chunk of packed storage */
+
+/*
+ * Packed storage for the values of numeric indexed arrays. The value of
+ * element i lives in slot i%ARRAY_SLOTS of chunk i/ARRAY_SLOTS, so it never
+ * moves and needs no allocation of its own. A clone that shares value
+ * pointers holds a reference; slots are only handed out while unshared.
+ */
+struct array_slots
+{
+	unsigned	refcount;
+	unsigned	size;		/* size of each slot */
+	unsigned	nchunks;
+	char		**chunks;
+};
 
 struct index_array
 {
@@ -51,15 +66,21 @@ struct index_array
 	int		cur;    	/* index of current element */
 	int		maxi;   	/* maximum index for array */
 	unsigned char	*bits;		/* bit array for child subscripts */
+	struct array_slots *slots;	/* packed storage for numeric values */
 	void		*val[1];	/* array of value holders */
 };
 
+static void array_freeslots(struct index_array*);
+
 struct assoc_array
 {
 	Namarr_t	header;
 	Namval_t	*pos;
 	Namval_t	*nextpos;
 	Namval_t	*cur;
+	Namval_t	**list;		/* sorted snapshot of the elements being scanned */
+	size_t		nlist;		/* number of entries in list */
+	size_t		next;		/* index of nextpos in list */
 };
 
 #if SHOPT_FIXEDARRAY
@@ -81,6 +102,109 @@ struct assoc_array
    static void array_fixed_setdata(Namval_t*,Namarr_t*,struct fixed_array*);
 #endif /* SHOPT_FIXEDARRAY */
 
+/*
+ * Associative arrays are kept in a hashed dictionary for fast lookup.
+ * To still give the elements in sorted order, a scan works on a sorted
+ * snapshot of the elements that is built when the scan starts.
+ */
+static int assoc_cmp(const void *a, const void *b)
+{
+	return strcmp((*(Namval_t**)a)->nvname,(*(Namval_t**)b)->nvname);
+}
+
+static void assoc_noscan(struct assoc_array *ap)
+{
+	ap->list = 0;
+	ap->nlist = ap->next = 0;
+}
+
+static void assoc_endscan(struct assoc_array *ap)
+{
+	free(ap->list);
+	assoc_noscan(ap);
+}
+
+/*
+ * Build the snapshot and return the index of the first element whose name
+ * is greater than <name>, or of <name> itself if <eq> is set
+ */
+static size_t assoc_scan(struct assoc_array *ap, const char *name, int eq)
+{
+	Dt_t		*root = ap->header.table;
+	Namval_t	*mp;
+	size_t		n=0, max=dtsize(root)+1, lo, hi, mid;
+	int		c;
+	ap->list = sh_realloc(ap->list,max*sizeof(Namval_t*));
+	for(mp=(Namval_t*)dtfirst(root); mp; mp=(Namval_t*)dtnext(root,mp))
+	{
+		if(n==max)
+			ap->list = sh_realloc(ap->list,(max*=2)*sizeof(Namval_t*));
+		ap->list[n++] = mp;
+	}
+	if(n>1)
+		qsort(ap->list,n,sizeof(Namval_t*),assoc_cmp);
+	ap->nlist = n;
+	if(!name)
+		return 0;
+	for(lo=0,hi=n; lo<hi;)
+	{
+		mid = (lo+hi)/2;
+		if((c=strcmp(ap->list[mid]->nvname,name))<0 || (c==0 && !eq))
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * Return the element following the one at index ap->next - 1
+ */
+static Namval_t *assoc_next(struct assoc_array *ap)
+{
+	while(ap->next < ap->nlist)
+	{
+		Namval_t *mp = ap->list[ap->next++];
+		if(mp)
+			return mp;
+	}
+	return NULL;
+}
+
+/*
+ * Remove <np> from the part of the snapshot that has not been scanned yet
+ */
+static void assoc_unscan(struct assoc_array *ap, Namval_t *np)
+{
+	size_t	lo=ap->next, hi=ap->nlist, mid, m;
+	int	c;
+	if(np==ap->nextpos)
+	{
+		ap->nextpos = assoc_next(ap);
+		return;
+	}
+	while(lo<hi)
+	{
+		/* skip entries of elements deleted earlier */
+		for(m=mid=(lo+hi)/2; m<hi && !ap->list[m]; m++);
+		if(m==hi)
+		{
+			hi = mid;
+			continue;
+		}
+		if((c=strcmp(ap->list[m]->nvname,np->nvname))==0)
+		{
+			if(ap->list[m]==np)
+				ap->list[m] = 0;
+			return;
+		}
+		if(c<0)
+			lo = m+1;
+		else
+			hi = mid;
+	}
+}
+
 static Namarr_t *array_scope(Namval_t *np, Namarr_t *ap, int flags)
 {
 	Namarr_t *aq;
@@ -97,7 +221,9 @@ static Namarr_t *array_scope(Namval_t *np, Namarr_t *ap, int flags)
 	aq->hdr.nofree |= (flags&NV_RDONLY)?1:0;
 	if(is_associative(aq))
 	{
-		aq->scope = dtopen(&_Nvdisc,Dtoset);
+		if(aq->fun==nv_associative)
+			assoc_noscan((struct assoc_array*)aq);
+		aq->scope = dtopen(&_Nvdisc,aq->table->meth);
 		dtview((Dt_t*)aq->scope,aq->table);
 		aq->table = (Dt_t*)aq->scope;
 		return aq;
@@ -116,6 +242,7 @@ static Namarr_t *array_scope(Namval_t *np, Namarr_t *ap, int flags)
 #endif /* SHOPT_FIXEDARRAY */
 	aq->scope = ap;
 	ar = (struct index_array*)aq;
+	ar->slots = 0;
 	memset(ar->val, 0, ar->maxi*sizeof(char*));
 	ar->bits =  (unsigned char*)&ar->val[ar->maxi];
 	return aq;
@@ -129,7 +256,11 @@ static int array_unscope(Namval_t *np,Namarr_t *ap)
 	if(is_associative(ap))
 		(*ap->fun)(np, NULL, NV_AFREE);
 	if((fp = nv_disc(np,(Namfun_t*)ap,NV_POP)) && !(fp->nofree&1))
+	{
+		if(!is_associative(ap) && !ap->fixed)
+			array_freeslots((struct index_array*)ap);
 		free(fp);
+	}
 	nv_delete(np,NULL,0);
 	return 1;
 }
@@ -193,6 +324,73 @@ int array_maxindex(Namval_t *np)
 	return i+1;
 }
 
+/*
+ * Return a packed slot for the value of the current element of <np>, or NULL
+ * if <vpp> is not that element's value holder or the array is not suitable
+ */
+void *nv_arrayslot(Namval_t *np, void **vpp, size_t size)
+{
+	struct index_array	*ap = (struct index_array*)nv_arrayptr(np);
+	struct array_slots	*sp;
+	unsigned		n;
+	if(!ap || is_associative(ap) || ap->header.fixed || ap->maxi < ARRAY_SLOTS || ap->cur >= ap->maxi || vpp != &ap->val[ap->cur])
+		return NULL;
+	if(!(sp = ap->slots))
+	{
+		sp = ap->slots = sh_newof(NULL,struct array_slots,1,0);
+		sp->refcount = 1;
+		sp->size = size;
+	}
+	else if(sp->refcount>1 || size > sp->size)
+		return NULL;
+	if((n = ap->cur/ARRAY_SLOTS) >= sp->nchunks)
+	{
+		sp->chunks = sh_realloc(sp->chunks,(n+1)*sizeof(char*));
+		memset(&sp->chunks[sp->nchunks],0,(n+1-sp->nchunks)*sizeof(char*));
+		sp->nchunks = n+1;
+	}
+	if(!sp->chunks[n])
+		sp->chunks[n] = sh_malloc(ARRAY_SLOTS*sp->size);
+	array_setbit(ap->bits,ap->cur,ARRAY_NOFREE);
+	nv_onattr(np,NV_NOFREE);
+	return sp->chunks[n] + (ap->cur%ARRAY_SLOTS)*sp->size;
+}
+
+/*
+ * Return true if the value of element <i> is held in its packed slot
+ */
+static int array_ispacked(struct index_array *ap, int i)
+{
+	struct array_slots	*sp = ap->slots;
+	unsigned		n = i/ARRAY_SLOTS;
+	return sp && n < sp->nchunks && sp->chunks[n] && ap->val[i] == sp->chunks[n] + (i%ARRAY_SLOTS)*sp->size;
+}
+
+/*
+ * Give element <i> a value of its own if it is held in a packed slot
+ */
+static void array_unpack(struct index_array *ap, int i)
+{
+	if(i < ap->maxi && array_ispacked(ap,i))
+	{
+		ap->val[i] = sh_memdup(ap->val[i],ap->slots->size);
+		array_clrbit(ap->bits,i,ARRAY_NOFREE);
+	}
+}
+
+static void array_freeslots(struct index_array *ap)
+{
+	struct array_slots	*sp = ap->slots;
+	ap->slots = 0;
+	if(sp && --sp->refcount==0)
+	{
+		while(sp->nchunks>0)
+			free(sp->chunks[--sp->nchunks]);
+		free(sp->chunks);
+		free(sp);
+	}
+}
+
 static void **array_getup(Namval_t *np, Namarr_t *arp, int update)
 {
 	struct index_array *ap = (struct index_array*)arp;
@@ -474,9 +672,19 @@ static Namfun_t *array_clone(Namval_t *np, Namval_t *mp, int flags, Namfun_t *fp
 		sh.prev_table = sh.last_table;
 		sh.prev_root = sh.last_root;
 	}
+	if(ap->fun==nv_associative)
+		assoc_noscan((struct assoc_array*)ap);
+	else if(!is_associative(ap) && !ap->fixed && (ar=(struct index_array*)ap)->slots)
+	{
+		/* a clone that shares the value pointers keeps their storage alive */
+		if(flags&NV_ARRAY)
+			ar->slots->refcount++;
+		else
+			ar->slots = 0;
+	}
 	if(ap->table)
 	{
-		ap->table = dtopen(&_Nvdisc,Dtoset);
+		ap->table = dtopen(&_Nvdisc,otable->meth);
 		if(ap->scope && !(flags&NV_COMVAR))
 		{
 			ap->scope = ap->table;
@@ -705,7 +913,10 @@ static void array_putval(Namval_t *np, const char *string, int flags, Namfun_t *
 		if(!is_associative(ap))
 		{
 			if(string)
-				array_clrbit(aq->bits,aq->cur,ARRAY_NOFREE);
+			{
+				if(!array_ispacked(aq,aq->cur))
+					array_clrbit(aq->bits,aq->cur,ARRAY_NOFREE);
+			}
 			else if(mp==np)
 				aq->val[aq->cur] = NULL;
 		}
@@ -751,6 +962,8 @@ static void array_putval(Namval_t *np, const char *string, int flags, Namfun_t *
 		}
 		if((nfp = nv_disc(np,(Namfun_t*)ap,NV_POP)) && !(nfp->nofree&1))
 		{
+			if(!is_associative(ap) && !ap->fixed)
+				array_freeslots(aq);
 			ap = 0;
 			free(nfp);
 		}
@@ -822,6 +1035,7 @@ static struct index_array *array_grow(Namval_t *np, struct index_array *arp,int
 	{
 		ap->header = arp->header;
 		ap->header.hdr.dsize = sizeof(*ap) + i;
+		ap->slots = arp->slots;
 		for(i=0;i < arp->maxi;i++)
 		{
 			ap->bits[i] = arp->bits[i];
@@ -949,11 +1163,13 @@ static Namarr_t *nv_changearray(Namval_t *np, void *(*fun)(Namval_t*,const char*
 			}
 			nv_putsub(np, string_index, ARRAY_ADD);
 			vpp = (void**)((*ap->fun)(np,NULL,0));
+			array_unpack(save_ap,dot);
 			*vpp = save_ap->val[dot];
 			save_ap->val[dot] = NULL;
 		}
 		string_index = &numbuff[NUMSIZE];
 	}
+	array_freeslots(save_ap);
 	free(save_ap);
 	return ap;
 }
@@ -1023,6 +1239,8 @@ Namval_t *nv_arraychild(Namval_t *np, Namval_t *nq, int c)
 		nv_putsub(np, NULL, ARRAY_FILL);
 		ap = nv_arrayptr(np);
 	}
+	if(!ap->fun && !ap->fixed)
+		array_unpack((struct index_array*)ap,((struct index_array*)ap)->cur);
 	if(!(vpp = array_getup(np,ap,0)))
 		return NULL;
 	np->nvalue = *vpp;
@@ -1655,7 +1873,7 @@ void *nv_associative(Namval_t *np,const char *sp,int mode)
 	{
 	    case NV_AINIT:
 		ap = (struct assoc_array*)sh_calloc(1,sizeof(struct assoc_array));
-		ap->header.table = dtopen(&_Nvdisc,Dtoset);
+		ap->header.table = dtopen(&_Nvdisc,Dtset);
 		ap->cur = 0;
 		ap->pos = 0;
 		ap->header.hdr.disc = &array_disc;
@@ -1668,6 +1886,8 @@ void *nv_associative(Namval_t *np,const char *sp,int mode)
 		{
 			if(!ap->header.scope || (Dt_t*)ap->header.scope==ap->header.table || !nv_search(ap->cur->nvname,(Dt_t*)ap->header.scope,0))
 				ap->header.nelem--;
+			if(ap->list && ap->cur!=ap->pos)
+				assoc_unscan(ap,ap->cur);
 			_nv_unset(ap->cur,NV_RDONLY);
 			nv_delete(ap->cur,ap->header.table,0);
 			ap->cur = 0;
@@ -1675,6 +1895,7 @@ void *nv_associative(Namval_t *np,const char *sp,int mode)
 		return ap;
 	    case NV_AFREE:
 		ap->pos = 0;
+		assoc_endscan(ap);
 		if(ap->header.scope)
 		{
 			ap->header.table = dtview(ap->header.table,NULL);
@@ -1697,14 +1918,14 @@ void *nv_associative(Namval_t *np,const char *sp,int mode)
 				ap->header.scope = dtvnext(ap->header.table);
 				ap->header.table->view = 0;
 			}
-			if(!(ap->pos=ap->cur))
-				ap->pos = (Namval_t*)dtfirst(ap->header.table);
+			ap->next = assoc_scan(ap,ap->cur?ap->cur->nvname:NULL,1);
+			ap->pos = assoc_next(ap);
 		}
 		else
 			ap->pos = ap->nextpos;
 		for(;ap->cur=ap->pos; ap->pos=ap->nextpos)
 		{
-			ap->nextpos = (Namval_t*)dtnext(ap->header.table,ap->pos);
+			ap->nextpos = assoc_next(ap);
 			if(!nv_isnull(ap->cur))
 			{
 				if((ap->header.nelem&ARRAY_NOCHILD) && nv_isattr(ap->cur,NV_CHILD))
@@ -1717,6 +1938,7 @@ void *nv_associative(Namval_t *np,const char *sp,int mode)
 			ap->header.table->view = (Dt_t*)ap->header.scope;
 			ap->header.scope = ap->header.table;
 		}
+		assoc_endscan(ap);
 		return NULL;
 	    case NV_ASETSUB:
 		ap->cur = (Namval_t*)sp;
@@ -1773,10 +1995,13 @@ void *nv_associative(Namval_t *np,const char *sp,int mode)
 			}
 			else if(ap->header.nelem&ARRAY_SCAN)
 			{
-				Namval_t fake;
-				fake.nvname = (char*)sp;
-				ap->pos = mp = (Namval_t*)dtprev(ap->header.table,&fake);
-				ap->nextpos = (Namval_t*)dtnext(ap->header.table,mp);
+				if(ap->next = assoc_scan(ap,sp,1))
+				{
+					ap->pos = mp = ap->list[ap->next-1];
+					ap->nextpos = assoc_next(ap);
+				}
+				else
+					ap->pos = ap->nextpos = mp = 0;
 			}
 			else if(!mp && *sp && mode==0)
 				mp = nv_search(sp,ap->header.table,NV_ADD|NV_NOSCOPE);
@@ -1784,7 +2009,11 @@ void *nv_associative(Namval_t *np,const char *sp,int mode)
 			if(ap->pos && ap->pos==np)
 				ap->header.nelem |= ARRAY_SCAN;
 			else if(!(ap->header.nelem&ARRAY_SCAN))
+			{
 				ap->pos = 0;
+				if(ap->list)
+					assoc_endscan(ap);
+			}
 			ap->cur = np;
 		}
 		if(ap->cur)
@@ -75,6 +75,8 @@ int path_expand(const char *pattern, struct argnod **arghead, int musttrim)
 		flags |= GLOB_MARK;
 	if(sh_isoption(SH_GLOBSTARS))
 		flags |= GLOB_STARSTAR;
+	if(sh_isoption(SH_GLOBCACHE))
+		flags |= GLOB_CACHE;
 #if SHOPT_GLOBCASEDET
 	if(sh_isoption(SH_GLOBCASEDET))
 		flags |= GLOB_DCASE;
@@ -649,6 +649,9 @@ noreturn void sh_done(int sig)
 		sh_offstate(SH_ERREXIT);
 		sh_chktrap();
 	}
+#if SHOPT_STATS
+	sh_profdump();
+#endif
 	nv_scan(sh.var_tree,array_notify,NULL,NV_ARRAY,NV_ARRAY);
 	sh_freeup();
 #if SHOPT_ACCT
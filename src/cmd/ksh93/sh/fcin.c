@@ -28,6 +28,37 @@
 #include	<sfio.h>
 #include	<error.h>
 #include	<fcin.h>
+#include	<ls.h>
+#include	<tmx.h>
+#include	<ast_mmap.h>
+
+#if _lib_mmap && _mmap_anon && defined(MAP_FIXED)
+#   define FCMMAP	1
+#   define FCMAPMIN	(64*1024)	/* smaller files take one read(2) anyway */
+
+/*
+ * sfio discipline for a stream whose file is mapped by fcmmap().
+ * fcfopen() hands the lexer the mapping itself; sfio reads and seeks on
+ * the stream are served from it as well, so the two stay in sync without
+ * any system calls. If the file is changed, the mapping is no longer used
+ * and reads go to the file again. Since a file that shrinks while it is
+ * mapped would make the lexer fault, fcfopen() checks the file each time
+ * it hands out the mapping.
+ */
+typedef struct _fcmap_
+{
+	Sfdisc_t	disc;
+	char		*addr;		/* mapping of the whole file */
+	size_t		len;		/* length of the mapping */
+	Sfoff_t		size;		/* size of the file when mapped */
+	Sfoff_t		here;		/* current file offset */
+	Time_t		mtime;		/* modification time when mapped */
+	int		stale;		/* file has changed since */
+} Fcmap_t;
+
+static int	fcmapvalid(Sfio_t*, Fcmap_t*);
+static ssize_t	fcmapread(Sfio_t*, void*, size_t, Sfdisc_t*);
+#endif /* _lib_mmap && _mmap_anon && MAP_FIXED */
 
 Fcin_t _Fcin = {0};
 
@@ -39,9 +70,26 @@ int	fcfopen(Sfio_t* f)
 	int	n;
 	char	*buff;
 	Fcin_t	save;
+#if FCMMAP
+	Fcmap_t	*mp;
+	Sfoff_t	here;
+#endif
 	errno = 0;
 	_Fcin.fcbuff = _Fcin.fcptr;
 	_Fcin._fcfile = f;
+#if FCMMAP
+	if((mp = (Fcmap_t*)sfdisc(f,(Sfdisc_t*)f)) && mp->disc.readf==fcmapread
+	&& (here = sftell(f)) >= 0 && here < mp->size && fcmapvalid(f,mp))
+	{
+		/* the rest of the file is the buffer; the 0 byte after it is already there */
+		_Fcin.fcmmap = 1;
+		_Fcin.fcoff = here;
+		_Fcin.fcptr = _Fcin.fcbuff = (unsigned char*)mp->addr + here;
+		_Fcin.fclast = (unsigned char*)mp->addr + mp->size;
+		return (int)(mp->size - here);
+	}
+#endif
+	_Fcin.fcmmap = 0;
 	fcsave(&save);
 	if(!(buff=(char*)sfreserve(f,SFIO_UNBOUND,SFIO_LOCKR)))
 	{
@@ -96,7 +144,10 @@ int	fcfill(void)
 	}
 	if((n = ptr-_Fcin.fcbuff) && _Fcin.fcfun)
 		(*_Fcin.fcfun)(f,(const char*)_Fcin.fcbuff,n,_Fcin.context);
-	sfread(f, (char*)_Fcin.fcbuff, n);
+	if(_Fcin.fcmmap)
+		sfseek(f, (Sfoff_t)n, SEEK_CUR);
+	else
+		sfread(f, (char*)_Fcin.fcbuff, n);
 	_Fcin.fcoff +=n;
 	_Fcin._fcfile = 0;
 	if(!last)
@@ -132,6 +183,137 @@ void fcnotify(void (*fun)(Sfio_t*,const char*,int,void*),void* context)
 	_Fcin.context = context;
 }
 
+#if FCMMAP
+/*
+ * Check that the file mapped for stream <f> has not been changed
+ */
+static int fcmapvalid(Sfio_t *f, Fcmap_t *mp)
+{
+	struct stat	statb;
+	if(!mp->stale && (fstat(sffileno(f),&statb) < 0 || statb.st_size!=mp->size || tmxgetmtime(&statb)!=mp->mtime))
+		mp->stale = 1;
+	return !mp->stale;
+}
+
+static ssize_t fcmapread(Sfio_t *f, void *buff, size_t n, Sfdisc_t *disc)
+{
+	Fcmap_t	*mp = (Fcmap_t*)disc;
+	ssize_t	r;
+	if(mp->here < mp->size && fcmapvalid(f,mp))
+	{
+		if((Sfoff_t)n > mp->size - mp->here)
+			n = (size_t)(mp->size - mp->here);
+		memcpy(buff, mp->addr + mp->here, n);
+		mp->here += n;
+		return n;
+	}
+	/* past the end of the mapping, or the file was changed */
+	if(lseek(sffileno(f),mp->here,SEEK_SET) < 0)
+		return -1;
+	if((r = sfrd(f,buff,n,disc)) > 0)
+		mp->here += r;
+	return r;
+}
+
+static Sfoff_t fcmapseek(Sfio_t *f, Sfoff_t off, int type, Sfdisc_t *disc)
+{
+	Fcmap_t		*mp = (Fcmap_t*)disc;
+	struct stat	statb;
+	switch(type)
+	{
+	    case SEEK_SET:
+		break;
+	    case SEEK_CUR:
+		off += mp->here;
+		break;
+	    case SEEK_END:
+		if(fstat(sffileno(f),&statb) < 0)
+			return -1;
+		off += statb.st_size;
+		break;
+	    default:
+		return -1;
+	}
+	if(off < 0)
+		return -1;
+	return mp->here = off;
+}
+
+static int fcmapexcept(Sfio_t *f, int type, void *data, Sfdisc_t *disc)
+{
+	Fcmap_t	*mp = (Fcmap_t*)disc;
+	NOT_USED(data);
+	if(type==SFIO_CLOSING || type==SFIO_DPOP)
+	{
+		/* leave the real file offset where a read(2) would have */
+		if(sffileno(f) >= 0)
+			lseek(sffileno(f),mp->here,SEEK_SET);
+	}
+	if(type==SFIO_DPOP || type==SFIO_FINAL)
+	{
+		munmap(mp->addr,mp->len);
+		free(disc);
+	}
+	return 0;
+}
+#endif /* FCMMAP */
+
+/*
+ * Map the rest of the regular file open on stream <f> into memory, so that
+ * fcfopen() can give the lexer all of it as one buffer that never needs to
+ * be refilled. Only large files are mapped. As fcfopen() checks the file
+ * each time, this only pays off for files parsed in one go, like dot scripts.
+ * Returns 1 if the file was mapped.
+ */
+int fcmmap(Sfio_t *f)
+{
+#if FCMMAP
+	Fcmap_t		*mp;
+	struct stat	statb;
+	Sfoff_t		here;
+	char		*addr;
+	size_t		len;
+	long		pagesize;
+	int		fd = sffileno(f);
+	if(fd < 0 || (sfset(f,0,0)&(SFIO_STRING|SFIO_SHARE|SFIO_WRITE)) || fstat(fd,&statb) < 0 || !S_ISREG(statb.st_mode)
+	|| statb.st_size <= FCMAPMIN || statb.st_size >= INT_MAX || (here = sftell(f)) < 0 || statb.st_size - here <= FCMAPMIN
+	|| (pagesize = sysconf(_SC_PAGESIZE)) <= 0)
+		return 0;
+	/*
+	 * Reserve at least one byte more than the file so that fcfopen() has
+	 * its terminating 0 byte even if the file size is a multiple of the
+	 * page size, then map the file over the start of that space.
+	 */
+	len = (statb.st_size/pagesize + 1) * pagesize;
+	if((addr = mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANON,-1,0)) == (char*)MAP_FAILED)
+		return 0;
+	if(mmap(addr,statb.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_FIXED,fd,0) == MAP_FAILED
+	|| !(mp = newof(0,Fcmap_t,1,0)))
+	{
+		munmap(addr,len);
+		return 0;
+	}
+	mp->disc.readf = fcmapread;
+	mp->disc.seekf = fcmapseek;
+	mp->disc.exceptf = fcmapexcept;
+	mp->addr = addr;
+	mp->len = len;
+	mp->size = statb.st_size;
+	mp->here = here;
+	mp->mtime = tmxgetmtime(&statb);
+	if(sfdisc(f,&mp->disc) != &mp->disc)
+	{
+		munmap(addr,len);
+		free(mp);
+		return 0;
+	}
+	return 1;
+#else
+	NOT_USED(f);
+	return 0;
+#endif /* FCMMAP */
+}
+
 #undef fcsave
 extern void fcsave(Fcin_t *fp)
 {
@@ -195,6 +195,7 @@ typedef struct _init_
 	Namfun_t	SECONDS_init;
 	struct rand	RAND_init;
 	Namfun_t	SRAND_init;
+	Namfun_t	REGCACHE_init;
 	Namfun_t	LINENO_init;
 	Namfun_t	L_ARG_init;
 	Namfun_t	SH_VERSION_init;
@@ -716,6 +717,49 @@ static char* get_srand(Namval_t* np, Namfun_t *fp)
 	return fmtint(n,1);
 }
 
+/*
+ * The following three functions are for ${.sh.regcache}, the limit on the
+ * number of compiled patterns that libast regcache() keeps
+ */
+
+#define REGCACHE_MAX	65536
+
+static void put_regcache(Namval_t* np,const char *val,int flags,Namfun_t *fp)
+{
+	Sfdouble_t d;
+	if(!val)  /* unset */
+	{
+		fp = nv_stack(np, NULL);
+		if(fp && !fp->nofree)
+			free(fp);
+		_nv_unset(np,NV_RDONLY);
+		return;
+	}
+	if(sh_isstate(SH_INIT))
+		return;
+	if(flags&NV_INTEGER)
+		d = *(Sfdouble_t*)val;
+	else
+		d = sh_arith(val);
+	if(d < 0 || d > REGCACHE_MAX)
+	{
+		errormsg(SH_DICT,ERROR_exit(1),e_number,fmtint((intmax_t)d,0));
+		UNREACHABLE();
+	}
+	/* 0 only flushes the cache */
+	regcache(NULL,(regflags_t)d,NULL);
+}
+
+static Sfdouble_t nget_regcache(Namval_t* np, Namfun_t *fp)
+{
+	return (Sfdouble_t)regcachestat()->max;
+}
+
+static char* get_regcache(Namval_t* np, Namfun_t *fp)
+{
+	return fmtint((intmax_t)regcachestat()->max,1);
+}
+
 /*
  * These three routines are for LINENO
  */
@@ -1016,6 +1060,7 @@ static const Namdisc_t OPTINDEX_disc	= {  sizeof(Namfun_t), put_optindex, 0, nge
 static const Namdisc_t SECONDS_disc	= {  sizeof(Namfun_t), put_seconds, get_seconds, nget_seconds };
 static const Namdisc_t RAND_disc	= {  sizeof(struct rand), put_rand, get_rand, nget_rand };
 static const Namdisc_t SRAND_disc	= {  sizeof(Namfun_t), put_srand, get_srand, nget_srand };
+static const Namdisc_t REGCACHE_disc	= {  sizeof(Namfun_t), put_regcache, get_regcache, nget_regcache };
 static const Namdisc_t LINENO_disc	= {  sizeof(Namfun_t), put_lineno, get_lineno, nget_lineno };
 static const Namdisc_t L_ARG_disc	= {  sizeof(Namfun_t), put_lastarg, get_lastarg };
 
@@ -1688,7 +1733,7 @@ static Namfun_t	 stat_child_fun =
 
 static void stat_init(void)
 {
-	int		i,nstat = STAT_SUBSHELL+1;
+	int		i,nstat = STAT_SUBFORK+1;
 	size_t		extrasize = nstat*(sizeof(int)+NV_MINSZ);
 	struct Stats	*sp = sh_newof(0,struct Stats,1,extrasize);
 	Namval_t	*np;
@@ -1704,6 +1749,9 @@ static void stat_init(void)
 		nv_setsize(np,10);
 		np->nvalue = &sh.stats[i];
 	}
+	/* the pattern cache is counted by libast */
+	nv_namptr(sp->nodes,STAT_REHITS)->nvalue = &regcachestat()->hits;
+	nv_namptr(sp->nodes,STAT_RECOMP)->nvalue = &regcachestat()->misses;
 	sp->hdr.dsize = sizeof(struct Stats) + extrasize;
 	sp->hdr.disc = &stat_disc;
 	nv_stack(SH_STATS,&sp->hdr);
@@ -1752,6 +1800,8 @@ static Init_t *nv_init(void)
 	ip->RAND_init.hdr.nofree = 1;
 	ip->SRAND_init.disc = &SRAND_disc;
 	ip->SRAND_init.nofree = 1;
+	ip->REGCACHE_init.disc = &REGCACHE_disc;
+	ip->REGCACHE_init.nofree = 1;
 	ip->SH_MATCH_init.hdr.disc = &SH_MATCH_disc;
 	ip->SH_MATCH_init.hdr.nofree = 1;
 	ip->SH_MATH_init.disc = &SH_MATH_disc;
@@ -1796,6 +1846,7 @@ static Init_t *nv_init(void)
 	nv_stack(RANDNOD, &ip->RAND_init.hdr);
 	nv_putval(RANDNOD, (char*)&d, NV_DOUBLE);
 	nv_stack(SRANDNOD, &ip->SRAND_init);
+	nv_stack(SH_REGCACHENOD, &ip->REGCACHE_init);
 	sh_invalidate_rand_seed();
 	nv_stack(LINENO, &ip->LINENO_init);
 	SH_MATCHNOD->nvfun =  &ip->SH_MATCH_init.hdr;
@@ -1817,7 +1868,7 @@ static Init_t *nv_init(void)
 	MCHKNOD->nvalue = &sh_mailchk;
 	OPTINDNOD->nvalue = &sh.st.optindex;
 	SH_LEVELNOD->nvalue = &sh.level;
-	sh.alias_tree = dtopen(&_Nvdisc,Dtoset);
+	sh.alias_tree = dtopen(&_Nvdisc,Dtset);
 	sh.track_tree = dtopen(&_Nvdisc,Dtset);
 	sh.bltin_tree = sh_inittree((const struct shtable2*)shtab_builtins);
 	sh.fun_base = sh.fun_tree = dtopen(&_Nvdisc,Dtoset);
@@ -45,6 +45,10 @@
 #include	"FEATURE/dynamic"
 #include	"FEATURE/poll"
 
+#if _lib_memfd_create
+#include	<sys/mman.h>
+#endif
+
 #ifdef	FNDELAY
 #   ifdef EAGAIN
 #	if EAGAIN!=EWOULDBLOCK
@@ -1560,6 +1564,33 @@ fail:
 	errormsg(SH_DICT,ERROR_system(1),message,fname);
 	UNREACHABLE();
 }
+/*
+ * Create an unnamed temporary file stream for a here-document.
+ * Where the system supports it, this is an anonymous memory-backed
+ * file, which has no path name that needs to be generated, created
+ * and removed again; otherwise, sftmp(3) creates a deleted file.
+ */
+static Sfio_t *heredoc_tmp(void)
+{
+#if _lib_memfd_create
+	static char	nomemfd;
+	Sfio_t		*sp;
+	int		fd;
+	if(!nomemfd)
+	{
+		if((fd = memfd_create("ksh-heredoc",0)) >= 0)
+		{
+			if(sp = sfnew(NULL,NULL,(size_t)SFIO_UNBOUND,fd,SFIO_READ|SFIO_WRITE))
+				return sp;
+			close(fd);
+		}
+		else if(errno==ENOSYS || errno==EPERM || errno==EINVAL)
+			nomemfd = 1;	/* not supported by the kernel or sandbox */
+	}
+#endif
+	return sftmp(0);
+}
+
 /*
  * Create a tmp file for the here-document
  */
@@ -1571,7 +1602,7 @@ static int io_heredoc(struct ionod *iop, const char *name, int traceon)
 	if(!(iop->iofile&IOSTRG) && (!sh.heredocs || iop->iosize==0))
 		return sh_open(e_devnull,O_RDONLY);
 	/* create an unnamed temporary file */
-	if(!(outfile=sftmp(0)))
+	if(!(outfile=heredoc_tmp()))
 	{
 		errormsg(SH_DICT,ERROR_system(1),e_tmpcreate);
 		UNREACHABLE();
@@ -1609,7 +1640,7 @@ static int io_heredoc(struct ionod *iop, const char *name, int traceon)
 		}
 		tmp = outfile;
 		if(fno>=0 && !(iop->iofile&IOQUOTE))
-			tmp = sftmp(iop->iosize<IOBSIZE?iop->iosize:0);
+			tmp = iop->iosize<IOBSIZE ? sftmp(iop->iosize) : heredoc_tmp();
 		if(fno>=0 || (iop->iofile&IOQUOTE))
 		{
 			/* This is a quoted here-document, not expansion */
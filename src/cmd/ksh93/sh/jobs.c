@@ -71,17 +71,24 @@
 #define wait    ______wait
 /*
  * This struct saves a link list of processes that have non-zero exit
- * status, have had $! saved, but haven't been waited for
+ * status, have had $! saved, but haven't been waited for.
+ * Each saved status is also hashed by process ID in savetab[].
  */
 struct jobsave
 {
-	struct jobsave	*next;
+	struct jobsave	*next;		/* next older saved status */
+	struct jobsave	*prev;		/* next newer saved status */
+	struct jobsave	*nxtpid;	/* next in PID hash chain */
 	pid_t		pid;
+	unsigned int	level;		/* subshell level, see job_subsave() */
 	unsigned short	exitval;
 };
 
 static struct jobsave *job_savelist;
 static int njob_savelist;
+static struct jobsave **savetab;
+static int savetabsize, nsaved;
+static int jobfree;	/* first byte of job.freejobs that may have a free job number */
 static struct process *pwfg;
 static int jobfork;
 
@@ -118,9 +125,13 @@ struct back_save
 {
 	int		count;
 	struct jobsave	*list;
+	struct jobsave	*last;
+	unsigned int	level;
 	struct back_save *prev;
 };
 
+#define PIDHASH(pid,size)	((unsigned int)(pid)&((size)-1))
+
 #define BYTE(n)		(((n)+CHAR_BIT-1)/CHAR_BIT)
 #define MAXMSG	25
 #define SH_STOPSIG	(SH_EXITSIG<<1)
@@ -157,11 +168,14 @@ struct back_save
 static int		job_chksave(pid_t);
 static struct process	*job_bypid(pid_t);
 static struct process	*job_byjid(int);
+static void		job_hashpid(struct process*);
+static void		job_unhashpid(struct process*);
 static char		*job_sigmsg(int);
 static int		job_alloc(void);
 static void		job_free(int);
 static struct process	*job_unpost(struct process*,int);
 static void		job_unlink(struct process*);
+static void		job_push(struct process*);
 static void		job_prmsg(struct process*);
 static struct process	*freelist;
 static char		beenhere;
@@ -225,7 +239,7 @@ void job_chldtrap(int unpost)
  */
 static struct jobsave *jobsave_create(pid_t pid)
 {
-	struct jobsave *jp = job_savelist;
+	struct jobsave *jp = job_savelist, **jpp;
 	job_chksave(pid);
 	if(++bck.count > sh.lim.child_max)
 		job_chksave(0);
@@ -239,9 +253,36 @@ static struct jobsave *jobsave_create(pid_t pid)
 	if(jp)
 	{
 		jp->pid = pid;
-		jp->next = bck.list;
+		jp->level = bck.level;
+		jp->prev = NULL;
+		if(jp->next = bck.list)
+			bck.list->prev = jp;
+		else
+			bck.last = jp;
 		bck.list = jp;
 		jp->exitval = 0;
+		if(++nsaved > savetabsize)
+		{
+			/* grow the hash table, keeping the order of each chain */
+			struct jobsave **oldtab = savetab, *jq, *jqnext;
+			int i, oldsize = savetabsize;
+			savetabsize = oldsize ? 2*oldsize : 64;
+			savetab = sh_newof(0,struct jobsave*,savetabsize,0);
+			for(i=0; i < oldsize; i++)
+			{
+				for(jq=oldtab[i]; jq; jq=jqnext)
+				{
+					jqnext = jq->nxtpid;
+					for(jpp=&savetab[PIDHASH(jq->pid,savetabsize)]; *jpp; jpp=&(*jpp)->nxtpid);
+					*jpp = jq;
+					jq->nxtpid = NULL;
+				}
+			}
+			free(oldtab);
+		}
+		jpp = &savetab[PIDHASH(pid,savetabsize)];
+		jp->nxtpid = *jpp;
+		*jpp = jp;
 	}
 	return jp;
 }
@@ -348,8 +389,7 @@ int job_reap(int sig)
 			{
 				/* move to top of job list */
 				job_unlink(px);
-				px->p_nxtjob = job.pwlist;
-				job.pwlist = px;
+				job_push(px);
 			}
 			continue;
 		}
@@ -702,6 +742,147 @@ void job_bwait(char **jobs)
 	}
 }
 
+/*
+ * wait -n built-in command: wait for the next of the given <jobs> to complete, or for the
+ * next job if none are given. Jobs that have already completed are reported first.
+ * Returns the process ID of the job and sets sh.exitval to its exit status;
+ * if there is no such job, returns 0 and sets sh.exitval to 127.
+ */
+pid_t job_waitnext(char **jobs)
+{
+	struct process	*pw, *px, *done;
+	pid_t		pid = 0, *pids;
+	int		n, i, running, nochild;
+	for(n=0; jobs[n]; n++);
+	pids = stkalloc(sh.stk,(n+1)*sizeof(pid_t));
+	for(i=n=0; jobs[i]; i++)
+	{
+		if(*jobs[i] == '%')
+		{
+			job_lock();
+			pw = job_bystring(jobs[i]);
+			job_unlock();
+			if(pw)
+				pids[n++] = pw->p_pid;
+		}
+		else
+			pids[n++] = pid_fromstring(jobs[i]);
+	}
+	if(i && !n)
+	{
+		sh.exitval = ERROR_NOENT;
+		exitset();
+		return 0;
+	}
+	job_lock();
+	while(1)
+	{
+#if SHOPT_BGX
+		/* run any pending CHLD traps, so each job's trap runs before its completion is reported */
+		if(sh.sigflag[SIGCHLD]&SH_SIGTRAP)
+			job_chldtrap(0);
+#endif /* SHOPT_BGX */
+		done = 0;
+		running = 0;
+		if(n)
+		{
+			for(i=0; i < n; i++)
+			{
+				if(pw = job_bypid(pids[i]))
+				{
+					if(pw->p_env != sh.curenv)
+						continue;
+					/* a pid may be of any process in the job; wait for all of them */
+					px = job_byjid(pw->p_job);
+					for(pw=px; pw && (pw->p_flag&P_DONE); pw=pw->p_nxtproc);
+					if(!pw)
+					{
+						done = px;
+						pid = pids[i];
+						break;
+					}
+					if(!(px->p_flag&P_STOPPED))
+						running++;
+				}
+				else if((sh.exitval = job_chksave(pids[i])) >= 0)
+				{
+					pid = pids[i];
+					goto found;
+				}
+			}
+		}
+		else if(bck.last)
+		{
+			/* report the oldest saved exit status */
+			pid = bck.last->pid;
+			sh.exitval = job_chksave(pid);
+			goto found;
+		}
+		else
+		{
+			/* find the oldest job that has completed */
+			for(px=job.pwlist; px; px=px->p_nxtjob)
+			{
+				if(px->p_env != sh.curenv)
+					continue;
+				for(pw=px; pw && (pw->p_flag&P_DONE); pw=pw->p_nxtproc);
+				if(!pw)
+					done = px;
+				else if(!(px->p_flag&P_STOPPED))
+					running++;
+			}
+			if(done)
+				pid = done->p_pid;
+		}
+		if(done)
+		{
+			sh.exitval = done->p_exit;
+			if(done->p_flag&P_SIGNALLED)
+			{
+				sh.exitval |= SH_EXITSIG;
+				job_prmsg(done);
+			}
+			for(pw=done; pw; pw=pw->p_nxtproc)
+				pw->p_flag &= ~(P_EXITSAVE|P_NOTIFY|P_BG);
+			if(done->p_pid==sh.spid)
+				sh.spid = 0;
+			job_unpost(done,1);
+			goto found;
+		}
+		if(!running)
+			break;
+		sfsync(sfstderr);
+		job.waitsafe = 0;
+		nochild = job_reap(job.savesig);
+		if(job.waitsafe)
+			continue;
+		if(nochild)
+			break;
+		if(sh.trapnote&SH_SIGTRAP)
+		{
+			/* interrupted by a trapped signal other than CHLD */
+			for(i=sh.sigmax; i>0; i--)
+				if(i!=SIGCHLD && (sh.sigflag[i]&SH_SIGTRAP))
+					break;
+			if(i>0)
+			{
+				job_unlock();
+				sh.exitval = 1;
+				exitset();
+				return 0;
+			}
+		}
+	}
+	job_unlock();
+	sh.exitval = ERROR_NOENT;
+	exitset();
+	return 0;
+found:
+	job_unlock();
+	exitset();
+	return pid;
+}
+
 /*
  * execute function <fun> for each job
  */
@@ -1041,26 +1222,48 @@ void	job_clear(void)
 	struct process *pw, *px;
 	struct process *pwnext;
 	int j = BYTE(sh.lim.child_max);
-	struct jobsave *jp,*jpnext;
 	job_lock();
-	for(pw=job.pwlist; pw; pw=pwnext)
+	if(sh_isstate(SH_FORKED) && !bck.prev)
 	{
-		pwnext = pw->p_nxtjob;
-		while(px=pw)
-		{
-			pw = pw->p_nxtproc;
-			free(px);
-		}
+		/*
+		 * A forked child forgets the jobs of its parent. Freeing them
+		 * one by one would cost every child time proportional to the
+		 * number of jobs the parent has, so drop the tables instead;
+		 * the parent's copy of this memory is not affected.
+		 */
+		free(job.pidtab);
+		free(job.jobtab);
+		free(savetab);
+		job.pidtab = job.jobtab = NULL;
+		job.pidtabsize = job.jobtabsize = 0;
+		savetab = NULL;
+		savetabsize = nsaved = 0;
+		bck.list = bck.last = 0;
+		bck.count = 0;
 	}
-	for(jp=bck.list; jp;jp=jpnext)
+	else
 	{
-		jpnext = jp->next;
-		free(jp);
+		for(pw=job.pwlist; pw; pw=pwnext)
+		{
+			pwnext = pw->p_nxtjob;
+			while(px=pw)
+			{
+				pw = pw->p_nxtproc;
+				free(px);
+			}
+		}
+		/* delete the saved statuses of this subshell level only; a reused pid may be saved in another */
+		while(bck.last)
+			job_chksave(0);
+		if(job.pidtab)
+			memset(job.pidtab,0,job.pidtabsize*sizeof(struct process*));
+		if(job.jobtab)
+			memset(job.jobtab,0,job.jobtabsize*sizeof(struct process*));
 	}
-	bck.list = 0;
 	if(njob_savelist < NJOB_SAVELIST)
 		init_savelist();
 	job.pwlist = NULL;
+	jobfree = 0;
 	job.numpost=0;
 #if SHOPT_BGX
 	job.numbjob = 0;
@@ -1115,8 +1318,7 @@ int job_post(pid_t pid, pid_t join)
 		if(val && (pw=job_byjid(val)) != job.pwlist)
 		{
 			job_unlink(pw);
-			pw->p_nxtjob = job.pwlist;
-			job.pwlist = pw;
+			job_push(pw);
 		}
 	}
 	if(pw=freelist)
@@ -1128,22 +1330,23 @@ int job_post(pid_t pid, pid_t join)
 	if(join && job.pwlist)
 	{
 		/* join existing current job */
-		pw->p_nxtjob = job.pwlist->p_nxtjob;
 		pw->p_nxtproc = job.pwlist;
 		pw->p_job = job.pwlist->p_job;
+		job.pwlist = job.pwlist->p_nxtjob;
 	}
 	else
 	{
 		/* create a new job */
 		while((pw->p_job = job_alloc()) < 0)
 			job_wait((pid_t)1);
-		pw->p_nxtjob = job.pwlist;
 		pw->p_nxtproc = 0;
 	}
 	pw->p_exitval = job.exitval;
-	job.pwlist = pw;
+	job_push(pw);
+	job.jobtab[pw->p_job] = pw;
 	pw->p_env = sh.curenv;
 	pw->p_pid = pid;
+	job_hashpid(pw);
 	if(!sh.outpipe || sh.cpid==pid)
 		pw->p_flag = P_EXITSAVE;
 	pw->p_exitmin = sh.xargexit;
@@ -1197,34 +1400,76 @@ int job_post(pid_t pid, pid_t join)
 }
 
 /*
- * Returns a process structure give a process ID
+ * Add a posted process to the process ID hash table
  */
-static struct process *job_bypid(pid_t pid)
+static void job_hashpid(struct process *pw)
 {
-	struct process  *pw, *px;
-	for(pw=job.pwlist; pw; pw=pw->p_nxtjob)
-		for(px=pw; px; px=px->p_nxtproc)
+	struct process **pp;
+	if(job.numpost > job.pidtabsize)
+	{
+		/* grow the hash table, keeping the order of each chain */
+		struct process **oldtab = job.pidtab, *px, *pxnext;
+		int i, oldsize = job.pidtabsize;
+		job.pidtabsize = oldsize ? 2*oldsize : 64;
+		job.pidtab = sh_newof(0,struct process*,job.pidtabsize,0);
+		for(i=0; i < oldsize; i++)
 		{
-			if(px->p_pid==pid)
-				return px;
+			for(px=oldtab[i]; px; px=pxnext)
+			{
+				pxnext = px->p_nxtpid;
+				for(pp=&job.pidtab[PIDHASH(px->p_pid,job.pidtabsize)]; *pp; pp=&(*pp)->p_nxtpid);
+				*pp = px;
+				px->p_nxtpid = NULL;
+			}
 		}
-	return NULL;
+		free(oldtab);
+	}
+	pp = &job.pidtab[PIDHASH(pw->p_pid,job.pidtabsize)];
+	pw->p_nxtpid = *pp;
+	*pp = pw;
 }
 
 /*
- * return a pointer to a job given the job ID
+ * Remove a process from the process ID hash table
  */
-static struct process *job_byjid(int jobid)
+static void job_unhashpid(struct process *pw)
 {
-	struct process *pw;
-	for(pw=job.pwlist;pw; pw = pw->p_nxtjob)
+	struct process **pp;
+	for(pp=&job.pidtab[PIDHASH(pw->p_pid,job.pidtabsize)]; *pp; pp=&(*pp)->p_nxtpid)
 	{
-		if(pw->p_job==jobid)
+		if(*pp==pw)
+		{
+			*pp = pw->p_nxtpid;
 			break;
+		}
+	}
+}
+
+/*
+ * Returns a process structure give a process ID
+ */
+static struct process *job_bypid(pid_t pid)
+{
+	struct process *pw = NULL;
+	if(job.pidtab)
+	{
+		for(pw=job.pidtab[PIDHASH(pid,job.pidtabsize)]; pw; pw=pw->p_nxtpid)
+			if(pw->p_pid==pid)
+				break;
 	}
 	return pw;
 }
 
+/*
+ * return a pointer to a job given the job ID
+ */
+static struct process *job_byjid(int jobid)
+{
+	if(jobid>0 && jobid<job.jobtabsize)
+		return job.jobtab[jobid];
+	return NULL;
+}
+
 /*
  * print a signal message
  */
@@ -1477,8 +1722,7 @@ int job_switch(struct process *pw,int bgflag)
 	else
 	{
 		job_unlink(pw);
-		pw->p_nxtjob = job.pwlist;
-		job.pwlist = pw;
+		job_push(pw);
 		msg = "";
 	}
 	hist_list(sh.hist_ptr,outfile,pw->p_name,'&',";");
@@ -1588,6 +1832,7 @@ static struct process *job_unpost(struct process *pwtop,int notify)
 		}
 		pw->p_flag &= ~P_DONE;
 		job.numpost--;
+		job_unhashpid(pw);
 		pw->p_nxtjob = freelist;
 		freelist = pw;
 	}
@@ -1605,19 +1850,26 @@ static struct process *job_unpost(struct process *pwtop,int notify)
  */
 static void job_unlink(struct process *pw)
 {
-	struct process *px;
 	if(pw==job.pwlist)
 	{
 		job.pwlist = pw->p_nxtjob;
 		job.curpgid = 0;
-		return;
 	}
-	for(px=job.pwlist;px;px=px->p_nxtjob)
-		if(px->p_nxtjob == pw)
-		{
-			px->p_nxtjob = pw->p_nxtjob;
-			return;
-		}
+	else
+		pw->p_prvjob->p_nxtjob = pw->p_nxtjob;
+	if(pw->p_nxtjob)
+		pw->p_nxtjob->p_prvjob = pw->p_prvjob;
+}
+
+/*
+ * put a job at the front of the job list
+ */
+static void job_push(struct process *pw)
+{
+	pw->p_prvjob = NULL;
+	if(pw->p_nxtjob = job.pwlist)
+		job.pwlist->p_prvjob = pw;
+	job.pwlist = pw;
 }
 
 /*
@@ -1631,7 +1883,8 @@ static int job_alloc(void)
 	unsigned char *freeword;
 	int jmax = BYTE(sh.lim.child_max);
 	/* skip to first word with a free slot */
-	for(j=0;job.freejobs[j] == UCHAR_MAX; j++);
+	for(j=jobfree;job.freejobs[j] == UCHAR_MAX; j++);
+	jobfree = j;
 	if(j >= jmax)
 	{
 		struct process *pw;
@@ -1648,6 +1901,15 @@ static int job_alloc(void)
 	j *= CHAR_BIT;
 	for(j++;mask&(*freeword);j++,mask <<=1);
 	*freeword  |= mask;
+	if(j >= job.jobtabsize)
+	{
+		int n = job.jobtabsize;
+		job.jobtabsize = n ? 2*n : 64;
+		while(j >= job.jobtabsize)
+			job.jobtabsize *= 2;
+		job.jobtab = sh_newof(job.jobtab,struct process*,job.jobtabsize,0);
+		memset(&job.jobtab[n],0,(job.jobtabsize-n)*sizeof(struct process*));
+	}
 	return j;
 }
 
@@ -1656,8 +1918,12 @@ static int job_alloc(void)
  */
 static void job_free(int n)
 {
-	int j = (--n)/CHAR_BIT;
+	int j;
 	unsigned mask;
+	job.jobtab[n] = NULL;
+	j = (--n)/CHAR_BIT;
+	if(j < jobfree)
+		jobfree = j;
 	n -= j*CHAR_BIT;
 	mask = 1 << n;
 	job.freejobs[j]  &= ~mask;
@@ -1690,46 +1956,45 @@ static char *job_sigmsg(int sig)
  */
 static int job_chksave(pid_t pid)
 {
-	struct jobsave *jp = bck.list, *jpold=0;
-	int r= -1;
-	int count=bck.count;
+	struct jobsave *jp, **jpp;
 	struct back_save *bp= &bck;
-again:
-	while(jp && count-->0)
-	{
-		if(jp->pid==pid)
-			break;
-		if(pid==0 && !jp->next)
-			break;
-		jpold = jp;
-		jp = jp->next;
-	}
-	if(!jp && pid && (bp=bp->prev))
-	{
-		count = bp->count;
-		jp = bp->list;
-		jpold = 0;
-		goto again;
-	}
-	if(jp)
-	{
+	int r= -1;
+	if(pid)
+	{
+		if(!savetab)
+			return r;
+		for(jp=savetab[PIDHASH(pid,savetabsize)]; jp && jp->pid!=pid; jp=jp->nxtpid);
+		if(!jp)
+			return r;
+		/* find the subshell level it was saved in */
+		while(bp->level != jp->level)
+			bp = bp->prev;
+		r = jp->exitval;
+	}
+	else if(jp = bck.last)
 		r = 0;
-		if(pid)
-			r = jp->exitval;
-		if(jpold)
-			jpold->next = jp->next;
-		else
-			bp->list = jp->next;
-		bp->count--;
-		if(njob_savelist < NJOB_SAVELIST)
-		{
-			njob_savelist++;
-			jp->next = job_savelist;
-			job_savelist = jp;
-		}
-		else
-			free(jp);
+	else
+		return r;
+	if(jp->prev)
+		jp->prev->next = jp->next;
+	else
+		bp->list = jp->next;
+	if(jp->next)
+		jp->next->prev = jp->prev;
+	else
+		bp->last = jp->prev;
+	bp->count--;
+	for(jpp=&savetab[PIDHASH(jp->pid,savetabsize)]; *jpp!=jp; jpp=&(*jpp)->nxtpid);
+	*jpp = jp->nxtpid;
+	nsaved--;
+	if(njob_savelist < NJOB_SAVELIST)
+	{
+		njob_savelist++;
+		jp->next = job_savelist;
+		job_savelist = jp;
 	}
+	else
+		free(jp);
 	return r;
 }
 
@@ -1740,7 +2005,8 @@ void *job_subsave(void)
 	*bp = bck;
 	bp->prev = bck.prev;
 	bck.count = 0;
-	bck.list = 0;
+	bck.list = bck.last = 0;
+	bck.level++;
 	bck.prev = bp;
 	job_unlock();
 	return bp;
@@ -1751,18 +2017,20 @@ void job_subrestore(void* ptr)
 	struct jobsave *jp;
 	struct back_save *bp = (struct back_save*)ptr;
 	struct process *pw, *px, *pwnext;
-	struct jobsave *end=NULL;
 	job_lock();
 	for(jp=bck.list; jp; jp=jp->next)
+		jp->level = bp->level;
+	if(bck.last)
 	{
-		if (!jp->next)
-			end = jp;
+		if(bck.last->next = bp->list)
+			bp->list->prev = bck.last;
 	}
-	if(end)
-		end->next = bp->list;
 	else
 		bck.list = bp->list;
+	if(bp->last)
+		bck.last = bp->last;
 	bck.count += bp->count;
+	bck.level = bp->level;
 	bck.prev = bp->prev;
 	while(bck.count > sh.lim.child_max)
 		job_chksave(0);
@@ -196,6 +196,29 @@ static int lexfill(Lex_t *lp)
 	return c;
 }
 
+/*
+ * Skip over a run of single-byte characters that do not change the lexical state
+ * in one step, without the per-character overhead of STATE() and fcmbget().
+ * In a multibyte locale, a byte with the high bit set stops the scan and is
+ * left to STATE(). The input buffer is always terminated by a 0 byte, which
+ * is S_EOF in every state table, so this never runs past the end of it.
+ */
+static void lexscan(const char *state)
+{
+	const unsigned char *cp = _Fcin.fcptr;
+	if(mbwide())
+	{
+		while(!state[*cp] && *cp < 0x80)
+			cp++;
+	}
+	else
+	{
+		while(!state[*cp])
+			cp++;
+	}
+	_Fcin.fcptr = (unsigned char*)cp;
+}
+
 /*
  * mode=1 for reinitialization
  */
@@ -311,6 +334,8 @@ int sh_lex(Lex_t* lp)
 	{
 		/* skip over characters in the current state */
 		state = sh_lexstates[mode];
+		do
+			lexscan(state);
 		while((n=STATE(state,c))==0);
 		switch(n)
 		{
@@ -387,7 +412,8 @@ int sh_lex(Lex_t* lp)
 					lp->lexd.nocopy--;
 				do
 				{
-					while((c = fcgetc()) > 0 && c!='\n');
+					while((c = fcgetc()) > 0 && c!='\n')
+						fcseek(strcspn(fcseek(0),"\n"));
 					if(c<=0 || lp->heredoc)
 					{
 						sh.inlineno++;
@@ -1847,6 +1873,7 @@ static int here_copy(Lex_t *lp,struct ionod *iop)
 			/* skip over regular characters */
 			do
 			{
+				lexscan(state);
 				if(mbsize(fcseek(0)) < 0 && fcleft() < MB_LEN_MAX)
 				{
 					n = S_EOF;
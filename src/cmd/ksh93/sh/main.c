@@ -579,8 +579,11 @@ static void	exfile(Sfio_t *iop,int fno)
 		if(t)
 		{
 			execflags = sh_state(SH_ERREXIT)|sh_state(SH_INTERACTIVE);
-			/* The last command may not have to fork */
+			/* The last command may not have to fork (but the profiler must report on exit) */
 			if(!sh_isstate(SH_PROFILE) && !sh_isstate(SH_INTERACTIVE) &&
+#if SHOPT_STATS
+				!sh_isoption(SH_CMDPROFILE) &&
+#endif
 				(fno<0 || !(sh.fdstatus[fno]&(IOTTY|IONOSEEK)))
 				&& !sfreserve(iop,0,0))
 			{
@@ -33,6 +33,13 @@
 #include	"streval.h"
 
 #define NVCACHE		8	/* must be a power of 2 */
+
+/* integers below this are formatted the same by fmtint() and by "%.*Lg" with precision LDBL_DIG */
+#if LDBL_DIG >= 18
+#   define LDBL_INTFMT_MAX	1e18L
+#else
+#   define LDBL_INTFMT_MAX	1e15L
+#endif
 static char	*savesub = 0;
 static Namval_t	NullNode;
 static Dt_t	*Refdict;
@@ -42,6 +49,7 @@ static Dtdisc_t	_Refdisc =
 };
 
 static void	pushnam(Namval_t*,void*);
+static void	env_dirty(Namval_t*);
 static char	*staknam(Namval_t*, char*);
 static void	rightjust(char*, int, int);
 static char	*lastdot(char*, int);
@@ -55,6 +63,7 @@ struct adata
 	Namval_t	*tp;
 	char		*mapname;
 	char		**argnam;
+	struct envent	*ep;
 };
 
 /* for a 'typeset -T' type */
@@ -1083,6 +1092,11 @@ Namval_t *nv_create(const char *name,  Dt_t *root, int flags, Namfun_t *dp)
 						if(flags&NV_ASSIGN)
 							n |= NV_ADD;
 						cp = nv_endsubscript(np,sp,n|(flags&(NV_ASSIGN|NV_FARRAY)));
+#if NVCACHE
+						/* only a literal number subscript is sure to give the same node again */
+						if(cp-sp < 3 || strspn(sp+1,"0123456789") != cp-sp-2)
+							nvcache.ok = 0;
+#endif
 #if SHOPT_FIXEDARRAY
 						flags &= ~NV_FARRAY;
 						if(fixed)
@@ -1592,6 +1606,18 @@ static void ja_restore(void);
 static char *savep;
 static char savechars[8+1];
 
+/*
+ * Allocate <size> bytes for a numeric value of <np> held in <vpp>;
+ * indexed array elements may use a packed slot of the array
+ */
+static void *num_alloc(Namval_t *np, void **vpp, size_t size)
+{
+	void	*vp;
+	if(vpp!=&np->nvalue && (vp = nv_arrayslot(np,vpp,size)))
+		return vp;
+	return sh_malloc(size);
+}
+
 /*
  * put value <string> into name-value node <np>.
  * If <np> is an array, then the element given by the
@@ -1644,7 +1670,7 @@ void nv_putval(Namval_t *np, const char *string, int flags)
 			nv_local=1;
 			nv_putv(np,sp,flags,np->nvfun);
 			if(sp && ((flags&NV_EXPORT) || nv_isattr(np,NV_EXPORT)))
-				env_change();
+				env_dirty(np);
 			return;
 		}
 		/* called from disc, assign the actual value */
@@ -1687,7 +1713,7 @@ void nv_putval(Namval_t *np, const char *string, int flags)
 				else
 					ld = sh_arith(sp);
 				if(!*vpp)
-					*vpp = new_of(Sfdouble_t,0);
+					*vpp = num_alloc(np,vpp,sizeof(Sfdouble_t));
 				else if(flags&NV_APPEND)
 					old = *(Sfdouble_t*)*vpp;
 				*(Sfdouble_t*)*vpp = old ? ld+old : ld;
@@ -1707,7 +1733,7 @@ void nv_putval(Namval_t *np, const char *string, int flags)
 				else
 					d = sh_arith(sp);
 				if(!*vpp)
-					*vpp = new_of(double,0);
+					*vpp = num_alloc(np,vpp,sizeof(double));
 				else if(flags&NV_APPEND)
 					od = *(double*)*vpp;
 				*(double*)*vpp = od ? d+od : d;
@@ -1751,7 +1777,7 @@ void nv_putval(Namval_t *np, const char *string, int flags)
 				else if(sp)
 					ll = (Sflong_t)sh_arith(sp);
 				if(!*vpp)
-					*vpp = new_of(Sflong_t,0);
+					*vpp = num_alloc(np,vpp,sizeof(Sflong_t));
 				else if(flags&NV_APPEND)
 					oll = *(Sflong_t*)*vpp;
 				*(Sflong_t*)*vpp = ll + oll;
@@ -1805,7 +1831,7 @@ void nv_putval(Namval_t *np, const char *string, int flags)
 				{
 					int16_t os=0;
 					if(!*vpp)
-						*vpp = new_of(int16_t,0);
+						*vpp = num_alloc(np,vpp,sizeof(int16_t));
 					else if(flags&NV_APPEND)
 						os = *(int16_t*)*vpp;
 					*(int16_t*)*vpp = os + (int16_t)l;
@@ -1814,7 +1840,7 @@ void nv_putval(Namval_t *np, const char *string, int flags)
 				{
 					int32_t ol=0;
 					if(!*vpp)
-						*vpp = new_of(int32_t,0);
+						*vpp = num_alloc(np,vpp,sizeof(int32_t));
 					else if(flags&NV_APPEND)
 						ol = *(int32_t*)*vpp;
 					*(int32_t*)*vpp = l + ol;
@@ -1829,7 +1855,14 @@ void nv_putval(Namval_t *np, const char *string, int flags)
 #if _lib_pathnative
 		char buff[PATH_MAX];
 #endif /* _lib_pathnative */
-		if(flags&NV_INTEGER)
+		if((flags&(NV_DOUBLE|NV_LONG))==(NV_DOUBLE|NV_LONG)
+		&& *(Sfdouble_t*)sp && *(Sfdouble_t*)sp > -LDBL_INTFMT_MAX && *(Sfdouble_t*)sp < LDBL_INTFMT_MAX
+		&& (Sflong_t)*(Sfdouble_t*)sp == *(Sfdouble_t*)sp)
+		{
+			/* fast path for integer results of arithmetic assignments */
+			sp = fmtint((Sflong_t)*(Sfdouble_t*)sp,0);
+		}
+		else if(flags&NV_INTEGER)
 		{
 			if((flags&NV_DOUBLE)==NV_DOUBLE)
 			{
@@ -2017,7 +2050,7 @@ void nv_putval(Namval_t *np, const char *string, int flags)
 			free((void*)tofree);
 	}
 	if(!was_local && ((flags&NV_EXPORT) || nv_isattr(np,NV_EXPORT)))
-		env_change();
+		env_dirty(np);
 	return;
 }
 
@@ -2134,42 +2167,212 @@ static char *staknam(Namval_t *np, char *value)
 	return q;
 }
 
+/*
+ * The environment list for child processes is cached between calls to sh_envgen().
+ * The cache is valid as long as ast.env_serial and sh.var_tree are unchanged.
+ * Assigning to an exported variable that is in the cache only marks its entry
+ * as dirty (see env_dirty()), so the next sh_envgen() regenerates that entry
+ * alone. Any other change to the environment invalidates the cache; it is then
+ * regenerated by scanning sh.var_tree, reusing each cached name=value string
+ * whose value is unchanged. The values of variables with discipline functions
+ * (including special variables), numeric variables and references can change
+ * without an assignment, so these are marked volatile and regenerated every time.
+ */
+#define ENV_VOLATILE	1	/* regenerate on every call */
+#define ENV_DIRTY	2	/* value was assigned since generated */
+
+struct envent
+{
+	Namval_t	*np;	/* exported variable */
+	char		*str;	/* malloc'ed "name=value", or NULL */
+	char		flags;
+};
+
+static struct envcache
+{
+	struct envent	*ent;
+	int		nent;
+	int		*hash;		/* indices of ent[] by node address; -1 if empty */
+	int		hsize;		/* power of 2 */
+	Dt_t		*tree;		/* sh.var_tree when generated */
+	uint32_t	serial;		/* ast.env_serial when last validated */
+	char		busy;		/* set while sh_envgen() reads values */
+} envcache;
+
+#define envhash(np)	((unsigned int)((uintptr_t)(np)>>4))
+
+static char *envstr(Namval_t *np, const char *value)
+{
+	char	*name = nv_name(np), *cp;
+	size_t	n = strlen(name);
+	cp = sh_malloc(n+strlen(value)+2);
+	memcpy(cp,name,n);
+	cp[n] = '=';
+	strcpy(cp+n+1,value);
+	return cp;
+}
+
+static int envfind(Namval_t *np)
+{
+	unsigned int	h;
+	int		i;
+	if(!envcache.hsize)
+		return -1;
+	for(h=envhash(np); (i=envcache.hash[h&(envcache.hsize-1)]) >= 0; h++)
+		if(envcache.ent[i].np==np)
+			return i;
+	return -1;
+}
+
+/*
+ * Record an assignment to the exported variable <np>
+ */
+static void env_dirty(Namval_t *np)
+{
+	int	i;
+	if(envcache.serial==ast.env_serial && (i=envfind(np)) >= 0)
+	{
+		envcache.ent[i].flags |= ENV_DIRTY;
+		envcache.serial = env_change();
+	}
+	else
+		env_change();
+}
+
 /*
  * Called from sh_envgen() to push an individual variable to export
  */
 static void pushnam(Namval_t *np, void *data)
 {
-	char *value;
-	struct adata *ap = (struct adata*)data;
+	char		*value, *cp;
+	struct adata	*ap = (struct adata*)data;
+	struct envent	*ep;
+	int		i;
 	if(strchr(np->nvname,'.'))
 		return;
 	ap->tp = 0;
-	if(value=nv_getval(np))
-		*ap->argnam++ = staknam(np,value);
+	if(ap->argnam)
+	{
+		/* uncached */
+		if(value=nv_getval(np))
+			*ap->argnam++ = staknam(np,value);
+		return;
+	}
+	ep = ap->ep++;
+	ep->np = np;
+	ep->str = 0;
+	ep->flags = 0;
+	if(np->nvfun || nv_isattr(np,NV_INTEGER|NV_REF))
+		ep->flags = ENV_VOLATILE;
+	else if(value=nv_getval(np))
+	{
+		/* reuse the previously generated string if the value is the same */
+		if((i=envfind(np)) >= 0 && (cp=envcache.ent[i].str) && strcmp(strchr(cp,'=')+1,value)==0)
+		{
+			ep->str = cp;
+			envcache.ent[i].str = 0;
+		}
+		else
+			ep->str = envstr(np,value);
+	}
 }
 
 /*
- * Generate the environment list for the child.
+ * Regenerate the cache by scanning the variable tree
  */
-char **sh_envgen(void)
+static void envscan(void)
 {
-	char **er;
-	int namec;
-	struct adata data;
+	struct envent	*ent;
+	struct adata	data;
+	int		i, n, hsize;
+	unsigned int	h;
+	n = nv_scan(sh.var_tree,nullscan,NULL,NV_EXPORT,NV_EXPORT);
+	ent = sh_newof(0,struct envent,n+1,0);
 	data.tp = 0;
 	data.mapname = 0;
+	data.argnam = 0;
+	data.ep = ent;
+	nv_scan(sh.var_tree,pushnam,&data,NV_EXPORT,NV_EXPORT);
+	n = data.ep - ent;
+	for(i=0; i < envcache.nent; i++)
+		free(envcache.ent[i].str);
+	free(envcache.ent);
+	for(hsize=16; hsize < 2*n; hsize <<= 1);
+	if(hsize!=envcache.hsize)
+	{
+		free(envcache.hash);
+		envcache.hash = sh_malloc(hsize*sizeof(int));
+		envcache.hsize = hsize;
+	}
+	memset(envcache.hash,0xff,hsize*sizeof(int));
+	for(i=0; i < n; i++)
+	{
+		for(h=envhash(ent[i].np); envcache.hash[h&(hsize-1)] >= 0; h++);
+		envcache.hash[h&(hsize-1)] = i;
+	}
+	envcache.ent = ent;
+	envcache.nent = n;
+	envcache.tree = sh.var_tree;
+	envcache.serial = ast.env_serial;
+}
+
+/*
+ * Generate the environment list for the child.
+ * The list is on the stack; the strings it points to may be in the cache.
+ */
+char **sh_envgen(void)
+{
+	char		**er, **argnam, *value;
+	struct envent	*ep, *last;
 	/* L_ARGNOD gets generated automatically as full path name of command */
-	nv_offattr(L_ARGNOD,NV_EXPORT);
-	namec = nv_scan(sh.var_tree,nullscan,NULL,NV_EXPORT,NV_EXPORT);
-	namec += sh.save_env_n;
-	er = stkalloc(sh.stk,(namec+4)*sizeof(char*));
-	data.argnam = (er+=2) + sh.save_env_n;
+	if(nv_isattr(L_ARGNOD,NV_EXPORT))
+	{
+		nv_offattr(L_ARGNOD,NV_EXPORT);
+		env_change();
+	}
+	if(envcache.busy)
+	{
+		/* called from a discipline function invoked below; don't touch the cache */
+		struct adata	data;
+		int		namec = nv_scan(sh.var_tree,nullscan,NULL,NV_EXPORT,NV_EXPORT);
+		er = stkalloc(sh.stk,(namec+sh.save_env_n+4)*sizeof(char*));
+		data.tp = 0;
+		data.mapname = 0;
+		data.argnam = (er+=2) + sh.save_env_n;
+		if(sh.save_env_n)
+			memcpy(er,sh.save_env,sh.save_env_n*sizeof(char*));
+		nv_scan(sh.var_tree,pushnam,&data,NV_EXPORT,NV_EXPORT);
+		*data.argnam = 0;
+		return er;
+	}
+	if(!envcache.ent || envcache.serial!=ast.env_serial || envcache.tree!=sh.var_tree)
+		envscan();
+	er = stkalloc(sh.stk,(envcache.nent+sh.save_env_n+4)*sizeof(char*));
+	argnam = (er+=2) + sh.save_env_n;
 	/* Pass non-imported env vars to child */
 	if(sh.save_env_n)
 		memcpy(er,sh.save_env,sh.save_env_n*sizeof(char*));
 	/* Add exported vars */
-	nv_scan(sh.var_tree, pushnam,&data,NV_EXPORT, NV_EXPORT);
-	*data.argnam = 0;
+	envcache.busy = 1;
+	for(ep=envcache.ent, last=ep+envcache.nent; ep < last; ep++)
+	{
+		if(ep->flags&ENV_VOLATILE)
+		{
+			if(value=nv_getval(ep->np))
+				*argnam++ = staknam(ep->np,value);
+			continue;
+		}
+		if(ep->flags&ENV_DIRTY)
+		{
+			free(ep->str);
+			ep->str = (value=nv_getval(ep->np)) ? envstr(ep->np,value) : 0;
+			ep->flags &= ~ENV_DIRTY;
+		}
+		if(ep->str)
+			*argnam++ = ep->str;
+	}
+	envcache.busy = 0;
+	*argnam = 0;
 	return er;
 }
 
@@ -574,6 +574,7 @@ char *nv_setdisc(Namval_t* np,const char *event,Namval_t *action,Namfun_t *fp)
 			dp->getnum = lookupn;
 		vp->disc[type] = action;
 		nv_optimize_clear(np);
+		sh.discfun = 1;
 	}
 	else
 	{
@@ -634,6 +635,7 @@ static char *setdisc(Namval_t* np,const char *event,Namval_t *action,Namfun_t *f
 			UNREACHABLE();
 		}
 		vp->bltins[type] = action;
+		sh.discfun = 1;
 	}
 	else
 	{
@@ -30,6 +30,7 @@
 #include	"variables.h"
 #include	"path.h"
 #include	"io.h"
+#include	"shnodes.h"
 #include	"jobs.h"
 #include	"history.h"
 #include	"test.h"
@@ -239,7 +240,11 @@ char *path_pwd(void)
 			nv_putval(pwdnod,cp,NV_RDONLY);
 		}
 	}
-	nv_onattr(pwdnod,NV_EXPORT);
+	if(!nv_isattr(pwdnod,NV_EXPORT))
+	{
+		nv_onattr(pwdnod,NV_EXPORT);
+		env_change();
+	}
 	/* Neither obtained the pwd nor can fall back to sane-ish $PWD: fall back to "." */
 	if(!cp)
 		cp = nv_getval(pwdnod);
@@ -576,7 +581,7 @@ static void funload(int fno, const char *name)
 	sh.funload = 1;
 	sh.inlineno = 1;
 	error_info.line = 0;
-	sh_eval(sfnew(NULL,buff,IOBSIZE,fno,SFIO_READ),SH_FUNEVAL);
+	sh_eval(sh_tcacheopen(sfnew(NULL,buff,IOBSIZE,fno,SFIO_READ),pname),SH_FUNEVAL);
 	sh_close(fno);
 	sh.readscript = 0;
 #if SHOPT_NAMESPACE
@@ -1336,17 +1341,21 @@ static noreturn void exscript(char *path,char *argv[],char **envp)
 		sh.sigflag[SIGCHLD] = SH_SIGFAULT;
 	/*
 	 * Export -x vars to new environment now, before longjmp & removing any local scope.
-	 * Since sh_envgen() puts it all on the stack, create a stack to preserve 'environ'.
+	 * Since sh_envgen() puts the list on the stack and its strings may be in the environment cache
+	 * which is changed by later calls, create a stack to preserve 'environ' and copy the strings to it.
 	 */
 	{
 		static Stk_t	*envstk;
 		Stk_t		*savstk = sh.stk;
+		char		**ep;
 		if (envstk)
 			stkset(envstk, NULL, 0);
 		else
 			envstk = stkopen(STK_SMALL);
 		sh.stk = envstk;
 		environ = sh_envgen();
+		for (ep = environ; *ep; ep++)
+			*ep = stkcopy(envstk, *ep);
 		sh.stk = savstk;
 		stkfreeze(envstk,0);
 	}
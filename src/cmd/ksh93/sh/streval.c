@@ -72,6 +72,9 @@ struct vars				/* vars stacked per invocation */
 	char		infun;	/* incremented by comma inside function	*/
 	int		emode;
 	Sfdouble_t	(*convert)(const char**,struct lval*,int,Sfdouble_t);
+	int		numend;		/* offset after last A_PUSHN, or -1 */
+	int		nnums;		/* number of consecutive A_PUSHN before numend */
+	int		numoff[4];	/* offsets of the last nnums A_PUSHN */
 };
 
 typedef Sfdouble_t (*Math_f)(Sfdouble_t,...);
@@ -551,6 +554,123 @@ static int gettok(struct vars *vp)
 	}
 }
 
+/*
+ * Constant folding: when an operator is applied to operands that were all
+ * pushed by the immediately preceding A_PUSHN instructions, compute the result
+ * now and replace the operand instructions by one A_PUSHN. This is only done for
+ * integer operands and for operators that cannot fail, so that arith_exec()
+ * would have produced the same value and the same errors.
+ */
+#define numptr(off)	((Sfdouble_t*)stkptr(sh.stk,round((off)+1,pow2size(sizeof(Sfdouble_t)))))
+#define numtype(off)	(*(char*)(numptr(off)+1))
+
+static void pushnum(struct vars *vp, Sfdouble_t d, int isfloat)
+{
+	int start = stktell(sh.stk);
+	sfputc(sh.stk,A_PUSHN);
+	stkpush(sh.stk,vp,d,Sfdouble_t);
+	sfputc(sh.stk,isfloat);
+	if(vp->numend!=start)
+		vp->nnums = 0;
+	else if(vp->nnums==elementsof(vp->numoff))
+		memmove(vp->numoff,vp->numoff+1,--vp->nnums*sizeof(*vp->numoff));
+	vp->numoff[vp->nnums++] = start;
+	vp->numend = stktell(sh.stk);
+}
+
+static int fold(struct vars *vp, int op)
+{
+	int		binary = (op&T_BINARY)!=0, off;
+	Sfdouble_t	num, left = 0;
+	if(vp->numend!=stktell(sh.stk) || vp->nnums < 1+binary)
+		return 0;
+	off = vp->numoff[vp->nnums-1];
+	num = *numptr(off);
+	if(numtype(off))
+		return 0;
+	if(binary)
+	{
+		off = vp->numoff[vp->nnums-2];
+		left = *numptr(off);
+		if(numtype(off))
+			return 0;
+	}
+	switch(op&T_OP)
+	{
+	    case A_NOT:
+		num = !num;
+		break;
+	    case A_UMINUS:
+		num = -num;
+		break;
+	    case A_TILDE:
+		num = ~((Sflong_t)(num));
+		break;
+	    case A_PLUS:
+		num += left;
+		break;
+	    case A_MINUS:
+		num = left - num;
+		break;
+	    case A_TIMES:
+		num *= left;
+		break;
+	    case A_MOD:
+		if(!(Sflong_t)num)
+			return 0;
+		num = (Sflong_t)(left) % (Sflong_t)(num);
+		break;
+	    case A_DIV:
+		if((Sfulong_t)(num < 0 ? -num : num)==0)
+			return 0;
+		num = (Sflong_t)(left) / (Sflong_t)(num);
+		break;
+	    case A_LSHIFT:
+		num = (Sflong_t)(left) << (long)(num);
+		break;
+	    case A_RSHIFT:
+		num = (Sflong_t)(left) >> (long)(num);
+		break;
+	    case A_XOR:
+		num = (Sflong_t)(left) ^ (Sflong_t)(num);
+		break;
+	    case A_OR:
+		num = (Sflong_t)(left) | (Sflong_t)(num);
+		break;
+	    case A_AND:
+		num = (Sflong_t)(left) & (Sflong_t)(num);
+		break;
+	    case A_EQ:
+		num = (left==num);
+		break;
+	    case A_NEQ:
+		num = (left!=num);
+		break;
+	    case A_LE:
+		num = (left<=num);
+		break;
+	    case A_GE:
+		num = (left>=num);
+		break;
+	    case A_GT:
+		num = (left>num);
+		break;
+	    case A_LT:
+		num = (left<num);
+		break;
+	    default:
+		return 0;
+	}
+	*numptr(off) = num;
+	if(binary)
+	{
+		vp->nnums--;
+		stkseek(sh.stk,vp->numoff[vp->nnums]);
+		vp->numend = stktell(sh.stk);
+	}
+	return 1;
+}
+
 /*
  * evaluate a subexpression with precedence
  */
@@ -595,7 +715,8 @@ again:
 	    common:
 		if(!expr(vp,c))
 			return 0;
-		sfputc(sh.stk,op);
+		if(!fold(vp,op))
+			sfputc(sh.stk,op);
 		break;
 	    default:
 		vp->nextchr = vp->errchr;
@@ -772,10 +893,12 @@ again:
 			sfputc(sh.stk,A_JMP);
 			offset2 = stkpush(sh.stk,vp,0,short);
 			*((short*)stkptr(sh.stk,offset1)) = stktell(sh.stk);
+			vp->numend = -1;
 			sfputc(sh.stk,A_POP);
 			if(!expr(vp,3))
 				return 0;
 			*((short*)stkptr(sh.stk,offset2)) = stktell(sh.stk);
+			vp->numend = -1;
 			lvalue.value = 0;
 			wasop = 0;
 			break;
@@ -800,6 +923,7 @@ again:
 			if(!expr(vp,c))
 				return 0;
 			*((short*)stkptr(sh.stk,offset)) = stktell(sh.stk);
+			vp->numend = -1;
 			if(op!=A_QCOLON)
 				sfputc(sh.stk,A_NOTNOT);
 			lvalue.value = 0;
@@ -813,7 +937,8 @@ again:
 		case A_PLUS:	case A_MINUS:	case A_TIMES:	case A_DIV:
 		case A_EQ:	case A_NEQ:	case A_LT:	case A_LE:
 		case A_GT:	case A_GE:	case A_POW:
-			sfputc(sh.stk,op|T_BINARY);
+			if(!fold(vp,op|T_BINARY))
+				sfputc(sh.stk,op|T_BINARY);
 			vp->staksize--;
 			break;
 		case A_NOT: case A_TILDE:
@@ -854,11 +979,9 @@ again:
 			}
 			if(op==A_DIG || op==A_LIT)
 			{
-				sfputc(sh.stk,A_PUSHN);
 				if(vp->staksize++>=vp->stakmaxsize)
 					vp->stakmaxsize = vp->staksize;
-				stkpush(sh.stk,vp,d,Sfdouble_t);
-				sfputc(sh.stk,lvalue.isfloat);
+				pushnum(vp,d,lvalue.isfloat);
 			}
 			/* check for function call */
 			if(lvalue.fun)
@@ -893,6 +1016,7 @@ Arith_t *arith_compile(const char *string,char **last,Sfdouble_t(*fun)(const cha
 	cur.emode = emode;
 	cur.errmsg.value = 0;
 	cur.errmsg.emode = emode;
+	cur.numend = -1;
 	stkseek(sh.stk,sizeof(Arith_t));
 	if(!expr(&cur,0) && cur.errmsg.value)
 	{
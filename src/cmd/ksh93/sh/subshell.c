@@ -27,6 +27,7 @@
 #include	"shopt.h"
 #include	"defs.h"
 #include	<ls.h>
+#include	<regex.h>
 #include	"io.h"
 #include	"fault.h"
 #include	"shnodes.h"
@@ -35,10 +36,6 @@
 #include	"variables.h"
 #include	"path.h"
 
-#ifndef PIPE_BUF
-#   define PIPE_BUF	512
-#endif
-
 #ifndef O_SEARCH
 #   ifdef O_PATH
 #	define O_SEARCH	O_PATH
@@ -48,17 +45,21 @@
 #endif
 
 /*
- * Note that the following structure must be the same
- * size as the Dtlink_t structure
+ * Note that the saved copy of the variable node starts at the dict
+ * member, so dict and node must be the same size as the Dtlink_t structure
  */
 struct Link
 {
 	struct Link	*next;
 	Namval_t	*child;
+	struct Link	*hnext;	/* next in svhash bucket */
 	Dt_t		*dict;
 	Namval_t	*node;
 };
 
+#define SVHASH_MIN	16	/* number of saved variables before svhash is used */
+#define svhash(np,mask)	((((uintptr_t)(np)>>4)^((uintptr_t)(np)>>12))&(mask))
+
 /*
  * The following structure is used for command substitution and (...)
  */
@@ -67,6 +68,9 @@ static struct subshell
 	struct subshell	*prev;	/* previous subshell data */
 	struct subshell	*pipe;	/* subshell where output goes to pipe on fork */
 	struct Link	*svar;	/* save shell variable table */
+	struct Link	**svhash; /* hash table indexing svar by node */
+	unsigned int	svcount;/* number of entries in svar */
+	unsigned int	svmask;	/* number of svhash buckets minus 1 */
 	Dt_t		*sfun;	/* function scope for subshell */
 	Dt_t		*strack;/* tracked alias scope for subshell */
 	Pathcomp_t	*pathlist; /* for PATH variable */
@@ -92,6 +96,7 @@ static struct subshell
 	int		rand_last;          /* last random number from $RANDOM in parent shell */
 	int		rand_state;         /* 0 means sp->rand_seed hasn't been set, 1 is the opposite */
 	uint32_t	srand_upper_bound;  /* parent shell's upper bound for $SRANDOM */
+	int		regcache_max;       /* parent shell's ${.sh.regcache} */
 #if _lib_fchdir
 	int		pwdfd;	/* file descriptor for PWD */
 	char		pwdclose;
@@ -102,13 +107,15 @@ static unsigned int subenv;
 
 
 /*
- * This routine will turn the sftmp() file into a real temporary file
+ * This routine will move the command substitution output collected in memory
+ * to a real temporary file, for commands that need a file descriptor
  */
 void	sh_subtmpfile(void)
 {
 	if(sfset(sfstdout,0,0)&SFIO_STRING)
 	{
 		int fd;
+		Sfio_t		*tp;
 		struct checkpt	*pp = (struct checkpt*)sh.jmplist;
 		struct subshell *sp = subshell_data->pipe;
 		/* save file descriptor 1 if open */
@@ -123,13 +130,15 @@ void	sh_subtmpfile(void)
 			errormsg(SH_DICT,ERROR_system(1),e_toomany);
 			UNREACHABLE();
 		}
-		/* popping a discipline forces a /tmp file create */
-		sfdisc(sfstdout,SFIO_POPDISC);
-		if((fd=sffileno(sfstdout))<0)
+		if(!(tp = sftmp(0)) || (fd=sffileno(tp))<0)
 		{
 			errormsg(SH_DICT,ERROR_SYSTEM|ERROR_PANIC,"could not create temp file");
 			UNREACHABLE();
 		}
+		if(sfstrtell(sfstdout) > 0)
+			sfwrite(tp,sfstrbase(sfstdout),sfstrtell(sfstdout));
+		sfswap(tp,sfstdout);
+		sfclose(tp);
 		sh.fdstatus[fd] = IOREAD|IOWRITE;
 		sfsync(sfstdout);
 		if(fd==1)
@@ -161,6 +170,7 @@ void sh_subfork(void)
 	char comsub = sh.comsub;
 	pid_t pid;
 	char *trap = sh.st.trapcom[0];
+	sh_stats(STAT_SUBFORK);
 	if(trap)
 		trap = sh_strdup(trap);
 	/* see whether inside $(...) */
@@ -199,29 +209,79 @@ void sh_subfork(void)
 	}
 }
 
+/*
+ * Return the link for node <np> saved in subshell <sp>, or NULL if not saved.
+ * Once a subshell saved more than a few variables, they are found through a
+ * hash table so that assignments in a subshell stay O(1) however many
+ * variables were modified in it.
+ */
+static struct Link *svar_find(struct subshell *sp, Namval_t *np)
+{
+	struct Link	*lp;
+	if(sp->svhash)
+	{
+		for(lp=sp->svhash[svhash(np,sp->svmask)]; lp; lp=lp->hnext)
+			if(lp->node==np)
+				return lp;
+		return NULL;
+	}
+	for(lp=sp->svar; lp; lp=lp->next)
+		if(lp->node==np)
+			return lp;
+	return NULL;
+}
+
+/*
+ * Add link <lp> to the table of saved variables of subshell <sp>.
+ */
+static void svar_add(struct subshell *sp, struct Link *lp)
+{
+	struct Link	*lq, **bp;
+	lp->next = sp->svar;
+	sp->svar = lp;
+	if(++sp->svcount < SVHASH_MIN)
+		return;
+	if(!sp->svhash || sp->svcount > sp->svmask)
+	{
+		/* (re)build the hash table with about two buckets per entry */
+		free(sp->svhash);
+		sp->svmask = sp->svmask ? (sp->svmask<<2)|3 : 2*SVHASH_MIN-1;
+		sp->svhash = sh_newof(0,struct Link*,sp->svmask+1,0);
+		for(lq=sp->svar; lq; lq=lq->next)
+		{
+			bp = &sp->svhash[svhash(lq->node,sp->svmask)];
+			lq->hnext = *bp;
+			*bp = lq;
+		}
+		return;
+	}
+	bp = &sp->svhash[svhash(lp->node,sp->svmask)];
+	lp->hnext = *bp;
+	*bp = lp;
+}
+
 int nv_subsaved(Namval_t *np, int flags)
 {
 	struct subshell	*sp;
-	struct Link		*lp, *lpprev;
+	struct Link		*lp, **lpp;
 	for(sp = (struct subshell*)subshell_data; sp; sp=sp->prev)
 	{
-		lpprev = 0;
-		for(lp=sp->svar; lp; lpprev=lp, lp=lp->next)
+		if(!(lp = svar_find(sp,np)))
+			continue;
+		if(flags&NV_TABLE)
 		{
-			if(lp->node==np)
+			for(lpp = &sp->svar; *lpp!=lp; lpp = &(*lpp)->next);
+			*lpp = lp->next;
+			if(sp->svhash)
 			{
-				if(flags&NV_TABLE)
-				{
-					if(lpprev)
-						lpprev->next = lp->next;
-					else
-						sp->svar = lp->next;
-					free(np);
-					free(lp);
-				}
-				return 1;
+				for(lpp = &sp->svhash[svhash(np,sp->svmask)]; *lpp!=lp; lpp = &(*lpp)->hnext);
+				*lpp = lp->hnext;
 			}
+			sp->svcount--;
+			free(np);
+			free(lp);
 		}
+		return 1;
 	}
 	return 0;
 }
@@ -274,14 +334,11 @@ void sh_assignok(Namval_t *np,int add)
 		if(!add || array_assoc(ap))
 			return;
 	}
-	for(lp=sp->svar; lp;lp = lp->next)
-	{
-		if(lp->node==np)
-			return;
-	}
-	/* first two pointers use linkage from np */
-	lp = (struct Link*)sh_malloc(sizeof(*np)+2*sizeof(void*));
-	memset(lp,0, sizeof(*mp)+2*sizeof(void*));
+	if(svar_find(sp,np))
+		return;
+	/* the pointers before dict are not part of the saved node */
+	lp = (struct Link*)sh_malloc(offsetof(struct Link,dict)+sizeof(*np));
+	memset(lp,0,offsetof(struct Link,dict)+sizeof(*np));
 	lp->node = np;
 	if(!add &&  nv_isvtree(np))
 	{
@@ -305,8 +362,7 @@ void sh_assignok(Namval_t *np,int add)
 	}
 	lp->dict = dp;
 	mp = (Namval_t*)&lp->dict;
-	lp->next = subshell_data->svar;
-	subshell_data->svar = lp;
+	svar_add(subshell_data,lp);
 	save = sh.subshell;
 	sh.subshell = 0;
 	mp->nvname = np->nvname;
@@ -329,6 +385,9 @@ static void nv_restore(struct subshell *sp)
 	Namval_t	*mpnext;
 	int		flags,nofree;
 	sh.nv_restore = 1;
+	/* nv_subsaved() may be called below; make it search the shrinking list */
+	free(sp->svhash);
+	sp->svhash = NULL;
 	for(lp=sp->svar; lp; lp=lq)
 	{
 		np = (Namval_t*)&lp->dict;
@@ -386,6 +445,7 @@ static void nv_restore(struct subshell *sp)
 		free(lp);
 		sp->svar = lq;
 	}
+	sp->svcount = 0;
 	sh.nv_restore = 0;
 }
 
@@ -589,6 +649,8 @@ Sfio_t *sh_subshell(Shnode_t *t, volatile int flags, int comsub)
 			sh.st.trap[SH_DEBUGTRAP] = save_debugtrap;
 		/* save upper bound for $SRANDOM */
 		sp->srand_upper_bound = sh.srand_upper_bound;
+		/* save the pattern cache limit */
+		sp->regcache_max = regcachestat()->max;
 	}
 	jmpval = sigsetjmp(checkpoint.buff,0);
 	if(jmpval==0)
@@ -606,8 +668,12 @@ Sfio_t *sh_subshell(Shnode_t *t, volatile int flags, int comsub)
 			sp->fdstatus = sh.fdstatus[1];
 			sp->tmpfd = -1;
 			sp->pipefd = -1;
-			/* use sftmp() file for standard output */
-			if(!(iop = sftmp(PIPE_BUF)))
+			/*
+			 * Collect standard output in a memory stream that grows as needed.
+			 * It is only moved to a temporary file by sh_subtmpfile() if a
+			 * command needs a real file descriptor, such as an external command.
+			 */
+			if(!(iop = sfnew(NULL,NULL,SFIO_UNBOUND,-1,SFIO_STRING|SFIO_READ|SFIO_WRITE)))
 			{
 				sfswap(sp->saveout,sfstdout);
 				errormsg(SH_DICT,ERROR_system(1),e_tmpcreate);
@@ -862,6 +928,9 @@ Sfio_t *sh_subshell(Shnode_t *t, volatile int flags, int comsub)
 		}
 		/* restore $SRANDOM upper bound */
 		sh.srand_upper_bound = sp->srand_upper_bound;
+		/* restore the pattern cache limit */
+		if(regcachestat()->max != sp->regcache_max)
+			regcache(NULL,(regflags_t)sp->regcache_max,NULL);
 		/* Real subshells have their exit status truncated to 8 bits by the kernel.
 		 * Since virtual subshells should be indistinguishable, do the same here. */
 		sh.exitval &= SH_EXITMASK;
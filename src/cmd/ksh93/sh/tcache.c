@@ -0,0 +1,147 @@
+/***********************************************************************
+*                                                                      *
+*              This file is part of the ksh 93u+m package              *
+*             Copyright (c) 2026 Contributors to ksh 93u+m             *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+*                  Martijn Dekker <martijn@inlv.org>                   *
+*            Johnothan King <johnothanking@protonmail.com>             *
+*                                                                      *
+***********************************************************************/
+/*
+ * parse tree cache for dot scripts and autoloaded functions
+ *
+ * If KSH_PARSECACHE contains the absolute path of a directory that is owned by
+ * the user and not writable by anyone else, the parse trees of dot scripts and
+ * autoloaded function files are saved there in the binary format of shcomp(1)
+ * as they are parsed by sh_eval(). A cache file is read instead of the script
+ * if it was written by the same ksh release, for the same file with the same
+ * device, inode, size and modification time, and with the same parser options.
+ *
+ * A cache file starts with that key in text form, followed by the shcomp header
+ * and the dumped parse trees.
+ */
+
+#include	"shopt.h"
+#include	"defs.h"
+#include	<ls.h>
+#include	<tmx.h>
+#include	"shnodes.h"
+#include	"version.h"
+
+#define CNTL(x)	((x)&037)
+static const char header[6] = { CNTL('k'),CNTL('s'),CNTL('h'),0,SHCOMP_HDR_VERSION,0 };
+
+struct tcache
+{
+	struct tcache	*next;
+	Sfio_t		*in;		/* script stream being parsed */
+	Sfio_t		*out;		/* temporary cache file */
+	char		*tmp;		/* name of temporary cache file */
+	char		*name;		/* name of cache file */
+};
+
+static struct tcache	*tclist;
+
+/*
+ * Return the cache directory, or NULL if the cache is not in use
+ */
+static char *tcachedir(void)
+{
+	Namval_t	*np;
+	char		*dir;
+	struct stat	statb;
+	if(sh.shcomp || sh_isoption(SH_RESTRICTED) || sh_isoption(SH_PRIVILEGED) || sh_isoption(SH_NOEXEC)
+	|| sh_isoption(SH_VERBOSE) || sh_isoption(SH_DICTIONARY))
+		return NULL;
+	if(!(np = nv_search("KSH_PARSECACHE",sh.var_tree,0)) || !(dir = nv_getval(np)) || *dir!='/')
+		return NULL;
+	if(stat(dir,&statb) < 0 || !S_ISDIR(statb.st_mode) || statb.st_uid!=geteuid() || (statb.st_mode&(S_IWGRP|S_IWOTH)))
+		return NULL;
+	return dir;
+}
+
+/*
+ * Return the stream to evaluate instead of <iop>, which is open on the file <path>.
+ * If there is no valid cache file for it, return <iop> and prepare to write one
+ * as sh_eval() parses <iop>.
+ */
+Sfio_t *sh_tcacheopen(Sfio_t *iop, const char *path)
+{
+	char		*dir, *key, *name, *buf;
+	struct stat	statb;
+	struct tcache	*tp;
+	Sfio_t		*cp;
+	size_t		n;
+	int		fd;
+	if(!path || !(dir = tcachedir()) || fstat(sffileno(iop),&statb) < 0 || !S_ISREG(statb.st_mode))
+		return iop;
+	sfprintf(sh.strbuf,"%s\n%s\n%llu %llu %lld %llu %c%c%c%c%c\n",SH_RELEASE,path,
+		(Sfulong_t)statb.st_dev, (Sfulong_t)statb.st_ino, (Sflong_t)statb.st_size, (Sfulong_t)tmxgetmtime(&statb),
+		sh_isoption(SH_POSIX) ? 'p' : '-',
+		sh_isoption(SH_BRACEEXPAND) ? 'B' : '-',
+		sh_isoption(SH_KEYWORD) ? 'k' : '-',
+		sh_isstate(SH_NOALIAS) ? 'a' : '-',
+		mbwide() ? 'm' : '-');
+	key = stkcopy(sh.stk,sfstruse(sh.strbuf));
+	n = strlen(key);
+	sfprintf(sh.strbuf,"%s/%08lx.kshc",dir,strsum(path,0L));
+	name = stkcopy(sh.stk,sfstruse(sh.strbuf));
+	if(cp = sfopen(NULL,name,"r"))
+	{
+		if(fstat(sffileno(cp),&statb) >= 0 && statb.st_uid==geteuid()
+		&& (buf = sfreserve(cp,n,SFIO_LOCKR)) && memcmp(buf,key,n)==0)
+		{
+			sfread(cp,buf,n);
+			fcntl(sffileno(cp),F_SETFD,FD_CLOEXEC);
+			sfclose(iop);
+			return cp;
+		}
+		sfclose(cp);
+	}
+	/* cache miss: write the trees to a temporary file and rename it into place when done */
+	if(!(buf = pathtemp(NULL,0,dir,"ksh",&fd)))
+		return iop;
+	fcntl(fd,F_SETFD,FD_CLOEXEC);
+	tp = sh_newof(0,struct tcache,1,0);
+	tp->in = iop;
+	tp->out = sfnew(NULL,NULL,SFIO_UNBOUND,fd,SFIO_WRITE);
+	tp->tmp = buf;
+	tp->name = sh_strdup(name);
+	sfwrite(tp->out,key,n);
+	sfwrite(tp->out,header,sizeof(header));
+	tp->next = tclist;
+	tclist = tp;
+	return iop;
+}
+
+/*
+ * Called by sh_eval() for each parse tree <t> read from <iop>.
+ * If <last> is 1, <t> is the last tree and the cache file is completed.
+ * If <last> is -1, parsing was interrupted and the cache file is discarded.
+ */
+void sh_tcachedump(Sfio_t *iop, const Shnode_t *t, int last)
+{
+	struct tcache	*tp, **tpp;
+	for(tpp = &tclist; tp = *tpp; tpp = &tp->next)
+		if(tp->in==iop)
+			break;
+	if(!tp)
+		return;
+	if(last >= 0 && sh_tdump(tp->out,t) < 0)
+		last = -1;
+	if(last)
+	{
+		*tpp = tp->next;
+		if(sfclose(tp->out) < 0 || last < 0 || rename(tp->tmp,tp->name) < 0)
+			unlink(tp->tmp);
+		free(tp->tmp);
+		free(tp->name);
+		free(tp);
+	}
+}
@@ -53,7 +53,8 @@
     extern int	nice(int);
 #endif /* _lib_nice */
 #if SHOPT_SPAWN
-    static pid_t sh_ntfork(const Shnode_t*,char*[],int*,int);
+    static pid_t sh_ntfork(const Shnode_t*,char*[],int*,int,int);
+    static char **spawn_argv(const Shnode_t*,int);
 #endif /* SHOPT_SPAWN */
 
 static void	sh_funct(Namval_t*, int, char*[], struct argnod*,int);
@@ -198,6 +199,230 @@ static void l_time(Sfio_t *outfile,clock_t t,int precision)
 #define TM_USR_IDX 1
 #define TM_SYS_IDX 2
 
+#if SHOPT_STATS
+/*
+ * Execution profiler for 'set -o profile'
+ *
+ * Every simple command, (( )) and [[ ]] command starts a new sample. The real,
+ * user and system time and the number of forks and spawns since the previous
+ * sample are charged to the script line that started it, so each line gets the
+ * time spent executing it, excluding time spent in lines of functions it calls.
+ * Functions get the total (inclusive) time and forks of their calls.
+ * The table is written to standard error, or to the file named by
+ * KSH_PROFILEFILE in a tab-separated format, when the shell exits.
+ */
+struct profent
+{
+	Dtlink_t	link;
+	char		*file;		/* script file name, or NULL */
+	char		*name;		/* function name, or NULL for a line */
+	int		line;
+	unsigned int	count;		/* number of executions or calls */
+	unsigned int	forks;		/* forks and spawns */
+	struct timeval	tm[3];		/* real, user, sys */
+};
+
+struct profsample
+{
+	struct timeval	tm[3];
+	unsigned int	forks;
+};
+
+static int prof_compare(Dt_t *dp, void *a, void *b, Dtdisc_t *disc)
+{
+	struct profent	*pa = a, *pb = b;
+	int		c;
+	NOT_USED(dp);
+	NOT_USED(disc);
+	if(!pa->name != !pb->name)
+		return pa->name ? 1 : -1;
+	if(pa->name && (c = strcmp(pa->name,pb->name)))
+		return c;
+	if(!pa->file != !pb->file)
+		return pa->file ? 1 : -1;
+	if(pa->file && (c = strcmp(pa->file,pb->file)))
+		return c;
+	return pa->line - pb->line;
+}
+
+static Dtdisc_t	prof_disc =
+{
+	0, sizeof(struct profent), offsetof(struct profent,link), 0, 0, prof_compare
+};
+
+static struct
+{
+	Dt_t		*dict;
+	struct profent	*cur;		/* line being executed */
+	struct profsample last;		/* taken when cur was entered */
+	pid_t		pid;		/* process that owns the table */
+} prof;
+
+static void prof_sample(struct profsample *sp)
+{
+#ifdef timeofday
+	timeofday(&sp->tm[TM_REAL_IDX]);
+	get_cpu_times(&sp->tm[TM_USR_IDX],&sp->tm[TM_SYS_IDX]);
+#else
+	memset(sp->tm,0,sizeof(sp->tm));
+#endif
+	sp->forks = sh.stats[STAT_FORKS] + sh.stats[STAT_SPAWN];
+}
+
+/*
+ * charge the time between samples <from> and <to> to entry <pp>
+ */
+static void prof_charge(struct profent *pp, struct profsample *from, struct profsample *to)
+{
+#ifdef timeofday
+	struct timeval	tv;
+	int		i;
+	for(i = 0; i < 3; i++)
+	{
+		timersub(&to->tm[i],&from->tm[i],&tv);
+		timeradd(&pp->tm[i],&tv,&pp->tm[i]);
+	}
+#endif
+	pp->forks += to->forks - from->forks;
+}
+
+static struct profent *prof_enter(const char *name, const char *file, int line)
+{
+	struct profent	key, *pp;
+	key.name = (char*)name;
+	key.file = (char*)file;
+	key.line = line;
+	if(!(pp = dtmatch(prof.dict,&key)))
+	{
+		pp = sh_newof(0,struct profent,1,0);
+		pp->name = name ? sh_strdup(name) : NULL;
+		pp->file = key.file ? sh_strdup(key.file) : NULL;
+		pp->line = line;
+		dtinsert(prof.dict,pp);
+	}
+	pp->count++;
+	return pp;
+}
+
+/*
+ * start or stop profiling
+ */
+void sh_profile(int on)
+{
+	struct profsample now;
+	prof_sample(&now);
+	if(prof.cur)
+		prof_charge(prof.cur,&prof.last,&now);
+	prof.cur = NULL;
+	if(!on)
+		return;
+	if(!prof.dict || prof.pid != sh.current_pid)
+	{
+		/* a forked child starts its own profile */
+		prof.dict = dtopen(&prof_disc,Dtoset);
+		prof.pid = sh.current_pid;
+	}
+	prof.last = now;
+}
+
+/*
+ * start a new sample for <line> of the current script or function
+ */
+static void prof_line(int line)
+{
+	struct profsample now;
+	if(!prof.dict)
+		return;
+	prof_sample(&now);
+	if(prof.cur)
+		prof_charge(prof.cur,&prof.last,&now);
+	if(prof.cur && prof.cur->line==line && !prof.cur->name && (prof.cur->file && sh.st.filename ?
+	   strcmp(prof.cur->file,sh.st.filename)==0 : prof.cur->file==sh.st.filename))
+		prof.cur->count++;
+	else
+		prof.cur = prof_enter(NULL,sh.st.filename,line);
+	prof.last = now;
+}
+
+static int prof_order(const void *a, const void *b)
+{
+	const struct profent	*pa = *(struct profent**)a, *pb = *(struct profent**)b;
+	if(!pa->name != !pb->name)
+		return pa->name ? -1 : 1;
+#ifdef timeofday
+	if(timercmp(&pa->tm[TM_REAL_IDX],&pb->tm[TM_REAL_IDX],!=))
+		return timercmp(&pa->tm[TM_REAL_IDX],&pb->tm[TM_REAL_IDX],<) ? 1 : -1;
+#endif
+	return prof_compare(NULL,(void*)pa,(void*)pb,NULL);
+}
+
+/*
+ * write the profile on exit; called from sh_done()
+ */
+void sh_profdump(void)
+{
+	struct profent	*pp, **list;
+	Namval_t	*np;
+	Sfio_t		*out = sfstderr;
+	char		*path;
+	size_t		n = 0, i;
+	if(!prof.dict || prof.pid != sh.current_pid)
+		return;
+	sh_profile(0);
+	if(!(n = dtsize(prof.dict)))
+		return;
+	list = sh_malloc(n * sizeof(struct profent*));
+	for(i = 0, pp = dtfirst(prof.dict); pp; pp = dtnext(prof.dict,pp))
+		list[i++] = pp;
+	qsort(list,n,sizeof(struct profent*),prof_order);
+	if((np = nv_search("KSH_PROFILEFILE",sh.var_tree,0)) && (path = nv_getval(np)) && *path)
+	{
+		if(!(out = sfopen(NULL,path,"w")))
+		{
+			errormsg(SH_DICT,ERROR_system(0),e_create,path);
+			out = sfstderr;
+		}
+	}
+	else
+		path = NULL;
+	if(out==sfstderr)
+		sfprintf(out,"%8s %8s %8s %8s %8s  %s\n","real","user","sys","count","forks","where");
+	for(i = 0; i < n; i++)
+	{
+		pp = list[i];
+		if(out!=sfstderr)
+			sfprintf(out,"%s\t%s\t%s\t%d\t%u\t%u\t%ld.%06ld\t%ld.%06ld\t%ld.%06ld\n",
+				pp->name ? "function" : "line",
+				pp->file ? pp->file : "",
+				pp->name ? pp->name : "",
+				pp->line, pp->count, pp->forks,
+				(long)pp->tm[0].tv_sec, (long)pp->tm[0].tv_usec,
+				(long)pp->tm[1].tv_sec, (long)pp->tm[1].tv_usec,
+				(long)pp->tm[2].tv_sec, (long)pp->tm[2].tv_usec);
+		else
+		{
+			sfprintf(out,"%4ld.%03ld %4ld.%03ld %4ld.%03ld %8u %8u  ",
+				(long)pp->tm[0].tv_sec, (long)pp->tm[0].tv_usec/1000,
+				(long)pp->tm[1].tv_sec, (long)pp->tm[1].tv_usec/1000,
+				(long)pp->tm[2].tv_sec, (long)pp->tm[2].tv_usec/1000,
+				pp->count, pp->forks);
+			if(pp->name)
+				sfprintf(out,"%s() ",pp->name);
+			sfprintf(out,"%s:%d",pp->file ? pp->file : error_info.id,pp->line);
+			sfputc(out,'\n');
+		}
+	}
+	if(out!=sfstderr)
+		sfclose(out);
+	else
+		sfsync(out);
+	free(list);
+}
+#   define prof_cmd(n)	do { if(sh_isoption(SH_CMDPROFILE)) prof_line(n); } while(0)
+#else
+#   define prof_cmd(n)
+#endif /* SHOPT_STATS */
+
 #ifdef timeofday
 static void p_time(Sfio_t *out, const char *format, struct timeval tm[3])
 #else
@@ -636,11 +861,14 @@ int sh_eval(Sfio_t *iop, int mode)
 		}
 		if(!(mode&SH_FUNEVAL) || !sfreserve(iop,0,0))
 		{
+			sh_tcachedump(iop,t,1);
 			if(!(mode&SH_READEVAL))
 				sfclose(iop);
 			io_save = 0;
 			mode &= ~SH_FUNEVAL;
 		}
+		else
+			sh_tcachedump(iop,t,0);
 		mode &= ~SH_READEVAL;
 		if(!sh_isoption(SH_VERBOSE))
 			sh_offstate(SH_VERBOSE);
@@ -654,6 +882,7 @@ int sh_eval(Sfio_t *iop, int mode)
 			break;
 	}
 	sh_popcontext(buffp);
+	sh_tcachedump(iop,NULL,-1);
 	sh.binscript = binscript;
 	sh.comsub = comsub;
 	if(traceon)
@@ -857,6 +1086,533 @@ static int check_exec_optimization(int type, int execflg, int execflg2, struct i
 	return 1;
 }
 
+/*
+ * Hot loop support. When a loop starts, the condition, body and increment of
+ * the loop are lowered into linear arrays of steps: lists are flattened, and
+ * each ((...)) command that was compiled by the parser is marked so it can be
+ * run directly by arith_exec(), without the general setup done by sh_exec().
+ * All other commands are executed by sh_exec() as usual.
+ */
+struct lstep
+{
+	const Shnode_t	*t;		/* command */
+	Arith_t		*ap;		/* compiled arithmetic command, or NULL */
+};
+
+struct lprog
+{
+	int		nsteps;
+	struct lstep	step[1];	/* actually nsteps */
+};
+
+static struct lprog *loop_compile(const Shnode_t *t)
+{
+	struct lprog	*pp;
+	struct lstep	*sp;
+	const Shnode_t	*tp;
+	int		n = 1;
+	if(!t)
+		return NULL;
+	for(tp = t; tp->tre.tretyp==TLST; tp = tp->lst.lstrit)
+		n++;
+	pp = stkalloc(sh.stk,sizeof(struct lprog)+(n-1)*sizeof(struct lstep));
+	pp->nsteps = n;
+	for(sp = pp->step; n--; sp++)
+	{
+		if(t->tre.tretyp==TLST)
+		{
+			sp->t = t->lst.lstlef;
+			t = t->lst.lstrit;
+		}
+		else
+			sp->t = t;
+		sp->ap = sp->t->tre.tretyp==TARITH ? (Arith_t*)sp->t->ar.arcomp : NULL;
+	}
+	return pp;
+}
+
+/*
+ * Execute a compiled ((...)) command; this is the TARITH case of sh_exec()
+ * minus what cannot apply when there is no DEBUG trap and no xtrace.
+ */
+static void loop_arith(const Shnode_t *t, Arith_t *ap, int flags)
+{
+	char	*sav = stkfreeze(sh.stk,0);
+	int	was_errexit = sh_isstate(SH_ERREXIT);
+	sh_sigcheck();
+	sh.lastsig = 0;
+	sh.chldexitsig = 0;
+	sh_offstate(SH_DEFPATH);
+	if(!(flags & sh_state(SH_ERREXIT)))
+		sh_offstate(SH_ERREXIT);
+	error_info.line = t->ar.arline-sh.st.firstline;
+	prof_cmd(t->ar.arline);
+	sh.exitval = !arith_exec(ap);
+	if(sh.trapnote)
+		sh_chktrap();
+	exitset();
+	if(!(flags & ARG_OPTIMIZE))
+	{
+		if(sav != stkptr(sh.stk,0))
+			stkset(sh.stk,sav,0);
+		else if(stktell(sh.stk))
+			stkseek(sh.stk,0);
+	}
+	if(sh.trapnote&SH_SIGSET)
+		sh_exit(SH_EXITSIG|sh.lastsig);
+	if(was_errexit)
+		sh_onstate(SH_ERREXIT);
+}
+
+/*
+ * Execute a lowered list of commands; equivalent to sh_exec() of the list.
+ */
+static int loop_exec(const struct lprog *pp, int flags)
+{
+	const struct lstep	*sp, *ep;
+	if(!pp)
+		return sh.exitval;
+	for(sp = pp->step, ep = sp + pp->nsteps; sp < ep; sp++)
+	{
+		if(sh.st.breakcnt || sh_isoption(SH_NOEXEC))
+			break;
+		if(sp->ap && !sh.st.trap[SH_DEBUGTRAP] && !sh_isoption(SH_XTRACE))
+			loop_arith(sp->t,sp->ap,flags);
+		else
+			sh_exec(sp->t,flags);
+	}
+	return sh.exitval;
+}
+
+#if SHOPT_OPTIMIZE
+/*
+ * Read-ahead for 'while read' loops. When standard input is a pipe, 'read'
+ * must not consume input beyond the delimiter, as another process may read
+ * the rest, and on a pipe that cannot be peeked at that means reading one
+ * byte per system call. But if the loop condition is a lone 'read' from
+ * standard input and the loop otherwise only runs built-in commands that
+ * cannot start a process, run a trap or leave the loop, then no other
+ * process can read standard input until the loop ends at end of file, when
+ * no input is left over. In that case, sh.readahead is set while the loop
+ * runs so that 'read' buffers standard input like any other stream.
+ *
+ * The input read ahead is lost if the loop ends in any other way, so the
+ * functions below also make sure that nothing in the loop can fail in a
+ * way that ends it: 'read' must assign to variables that cannot reject a
+ * value, special built-ins (whose errors exit the shell) must not fail, and
+ * there must be no expansion or arithmetic that can be an error, such as a
+ * division by zero or the use of a variable that may hold any string.
+ * Built-ins that change variable attributes are not allowed at all. Nor is
+ * there read-ahead where execution may resume after an error: in a subshell,
+ * in an interactive shell or with an ERR trap; or with 'set -e' or 'set -u',
+ * which turn common conditions into errors. Discipline functions can run
+ * any command when a variable is used, so once one has been defined, the
+ * shell no longer reads ahead at all.
+ */
+
+static const Shnode_t	*loop_node;	/* the loop checked by loop_readahead() */
+
+static int loop_safeword(const char *cp)
+{
+	for(; *cp; cp++)
+	{
+		if(*cp=='`' || *cp=='$' && cp[1]=='(')
+			return 0;	/* command substitution or arithmetic expansion */
+		if(*cp!='$' || cp[1]!='{')
+			continue;
+		/* ${name}, ${#name}, ${!name} and the operators that cannot fail */
+		cp += 2;
+		if(isspace(*cp) || *cp=='|')
+			return 0;	/* command substitution */
+		if(*cp=='#' || *cp=='!')
+			cp++;
+		while(isalnum(*cp) || *cp=='_' || *cp=='.')
+			cp++;
+		if(*cp==':')
+		{
+			if(cp[1]=='-' || cp[1]=='+')
+				continue;
+			/* substring with literal offset and length */
+			while(isdigit(*++cp) || *cp==':');
+			if(*cp!='}')
+				return 0;
+		}
+		else if(*cp=='=' || *cp=='?' || *cp=='[')
+			return 0;	/* assignment, error, or subscript with arithmetic */
+		cp--;
+	}
+	return 1;
+}
+
+static int loop_safeargs(const struct argnod *ap)
+{
+	for(; ap; ap = ap->argnxt.ap)
+	{
+		if(ap->argflag==ARG_RAW)
+			continue;
+		if(!*ap->argval || !loop_safeword(ap->argval))
+			return 0;	/* empty: process substitution or compound assignment */
+	}
+	return 1;
+}
+
+static int loop_safeio(const struct ionod *iop)
+{
+	for(; iop; iop = iop->ionxt)
+	{
+		if((iop->iofile&(IOPROCSUB|IOLSEEK))==IOPROCSUB)
+			return 0;
+		if((iop->iofile&(IODOC|IOSTRG|IOQUOTE))==IODOC)
+			return 0;	/* here-document with expansions */
+		if(!(iop->iofile&IORAW) && !loop_safeword(iop->ioname))
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Return argument <n> of the simple command <t>, counting its name as 0
+ */
+static const char *loop_arg(const Shnode_t *t, int n)
+{
+	const struct argnod	*ap;
+	const struct dolnod	*dp;
+	if(t->com.comtyp&COMSCAN)
+	{
+		for(ap = t->com.comarg.ap; ap && n; ap = ap->argnxt.ap)
+			n--;
+		return ap ? ap->argval : NULL;
+	}
+	if(!(dp = t->com.comarg.dp) || n >= dp->dolnum)
+		return NULL;
+	return dp->dolval[dp->dolbot+n];
+}
+
+/*
+ * Check whether the word <cp> may name the variable <name> of length <len>,
+ * followed by nothing or by one of the characters in <ends>
+ */
+static int loop_isname(const char *cp, const char *name, size_t len, const char *ends)
+{
+	if(strpbrk(cp,"$`"))
+		return 1;
+	return strncmp(cp,name,len)==0 && (!cp[len] || strchr(ends,cp[len]));
+}
+
+/*
+ * Check whether the tree <t> may assign a string that is not a number to
+ * the variable <name> of length <len>
+ */
+static int loop_writes(const Shnode_t *t, const char *name, size_t len)
+{
+	const struct argnod	*ap;
+	const struct regnod	*rp;
+	const char		*cp;
+	Namval_t		*np;
+	Shbltin_f		fp;
+	int			n;
+	if(!t)
+		return 0;
+	switch(t->tre.tretyp&COMMSK)
+	{
+	    case TCOM:
+		for(ap = t->com.comset; ap; ap = ap->argnxt.ap)
+			if(strncmp(ap->argval,name,len)==0 && strchr("=+[",ap->argval[len]))
+				return 1;
+		if(!(np = (Namval_t*)t->com.comnamp) || !(np = dtsearch(sh.fun_tree,np)) || !is_abuiltin(np))
+			return 0;
+		fp = funptr(np);
+		if(fp==b_read)
+		{
+			for(n = 1; cp = loop_arg(t,n); n++)
+				if(loop_isname(cp,name,len,"?"))
+					return 1;
+			return len==5 && strncmp(name,"REPLY",5)==0;
+		}
+		if(fp==b_getopts)
+			return (cp = loop_arg(t,2)) && loop_isname(cp,name,len,"") || len==6 && strncmp(name,"OPTARG",6)==0;
+		if(fp==b_print || fp==b_printf)
+		{
+			for(n = 1; (cp = loop_arg(t,n)) && *cp=='-'; n++)
+				if(cp = strchr(cp,'v'))
+					return *++cp ? loop_isname(cp,name,len,"") : (cp = loop_arg(t,n+1)) && loop_isname(cp,name,len,"");
+		}
+		return 0;
+	    case TTIME:
+		return loop_writes(t->par.partre,name,len);
+	    case TSETIO:
+		return loop_writes(t->fork.forktre,name,len);
+	    case TIF:
+		return loop_writes(t->if_.iftre,name,len) || loop_writes(t->if_.thtre,name,len) || loop_writes(t->if_.eltre,name,len);
+	    case TWH:
+		return loop_writes(t->wh.whtre,name,len) || loop_writes(t->wh.dotre,name,len);
+	    case TLST:
+	    case TAND:
+	    case TORF:
+		return loop_writes(t->lst.lstlef,name,len) || loop_writes(t->lst.lstrit,name,len);
+	    case TFOR:
+		return loop_isname(t->for_.fornam,name,len,"") || loop_writes(t->for_.fortre,name,len);
+	    case TSW:
+		for(rp = t->sw.swlst; rp; rp = rp->regnxt)
+			if(loop_writes(rp->regcom,name,len))
+				return 1;
+		return 0;
+	    case TTST:
+		return (t->tre.tretyp&TPAREN)==TPAREN && loop_writes(t->lst.lstlef,name,len);
+	}
+	return 0;
+}
+
+/*
+ * Look up the variable <name> of length <len> without creating it.
+ * Return 0 if it is not a plain variable name.
+ */
+static int loop_lookup(const char *name, size_t len, Namval_t **npp)
+{
+	const char	*cp = name;
+	if(!len || isdigit(*cp))
+		return 0;
+	for(; cp < name+len; cp++)
+		if(!isalnum(*cp) && *cp!='_' && *cp!='.')
+			return 0;
+	sfwrite(sh.strbuf,name,len);
+	*npp = nv_open(sfstruse(sh.strbuf),sh.var_tree,NV_VARNAME|NV_NOADD|NV_NOFAIL|NV_NOREF);
+	return 1;
+}
+
+/*
+ * Check whether a string can be assigned to the variable <name> of length <len>
+ */
+static int loop_safevar(const char *name, size_t len)
+{
+	Namval_t	*np;
+	if(!loop_lookup(name,len,&np))
+		return 0;
+	return !np || !nv_isattr(np,NV_RDONLY|NV_INTEGER|NV_REF);
+}
+
+/*
+ * Check whether the variable <name> of length <len> can be used in arithmetic:
+ * it must be an integer or hold a number that the loop replaces only by numbers
+ */
+static int loop_safenum(const char *name, size_t len)
+{
+	Namval_t	*np;
+	Namfun_t	*fp;
+	const char	*cp;
+	char		*ep;
+	if(!loop_lookup(name,len,&np))
+		return 0;
+	if(!np)
+		return !loop_writes(loop_node,name,len);
+	if(nv_isattr(np,NV_RDONLY|NV_REF))
+		return 0;
+	for(fp = np->nvfun; fp; fp = fp->next)
+		if(fp->disc)
+			return 0;
+	if(nv_isattr(np,NV_INTEGER))
+		return 1;
+	if(loop_writes(loop_node,name,len))
+		return 0;
+	if(!(cp = nv_getval(np)) || !*cp)
+		return 1;
+	if(*cp=='-' || *cp=='+')
+		cp++;
+	if(!isdigit(*cp) || *cp=='0' && isdigit(cp[1]) || cp[strspn(cp,"0123456789.+-eE")])
+		return 0;
+	strtold(cp,&ep);
+	return !*ep;
+}
+
+/*
+ * Check the arithmetic expression <cp> that was compiled when it was parsed
+ */
+static int loop_safearith(const char *cp)
+{
+	const char	*ep;
+	size_t		len;
+	while(*cp)
+	{
+		if(isdigit(*cp) || *cp=='.' && isdigit(cp[1]))
+		{
+			while(isalnum(*cp) || *cp=='.' || *cp=='_')
+				cp++;
+			continue;
+		}
+		if(isalpha(*cp) || *cp=='_' || *cp=='.')
+		{
+			for(ep = cp; isalnum(*ep) || *ep=='_' || *ep=='.'; ep++);
+			len = ep - cp;
+			while(isspace(*ep))
+				ep++;
+			/* math functions were checked when compiling; user-defined ones are not allowed */
+			if(*ep!='(' && !loop_safenum(cp,len))
+				return 0;
+			cp = ep;
+			continue;
+		}
+		if(*cp=='/' || *cp=='%')
+		{
+			/* division only by a nonzero constant */
+			for(ep = cp+1+(cp[1]=='='); isspace(*ep); ep++);
+			if(*ep<'1' || *ep>'9')
+				return 0;
+		}
+		else if(strchr("[#$'\"`\\",*cp))
+			return 0;
+		cp++;
+	}
+	return 1;
+}
+
+/*
+ * Check the arguments of 'read' for options and variables that cannot fail
+ */
+static int loop_saferead(const Shnode_t *t)
+{
+	const char	*cp, *arg;
+	int		n;
+	if(t->com.comtyp&COMSCAN)
+		return 0;
+	for(n = 1; (cp = loop_arg(t,n)) && *cp=='-' && cp[1]; n++)
+	{
+		if(strcmp(cp,"--")==0)
+		{
+			n++;
+			break;
+		}
+		while(*++cp)
+		{
+			if(strchr("AarSv",*cp))
+				continue;
+			if(!strchr("dnN",*cp))
+				return 0;	/* -C, -p, -s, -t and -u can fail or read elsewhere */
+			if(!*(arg = cp+1) && !(arg = loop_arg(t,++n)))
+				return 0;
+			if(*cp!='d' && (!*arg || arg[strspn(arg,"0123456789")]))
+				return 0;
+			break;
+		}
+	}
+	if(!loop_arg(t,n))
+		return loop_safevar("REPLY",5);
+	for(; cp = loop_arg(t,n); n++)
+		if(!loop_safevar(cp,strcspn(cp,"?")))
+			return 0;
+	return 1;
+}
+
+static int loop_safecom(const Shnode_t *t)
+{
+	Namval_t		*np = (Namval_t*)t->com.comnamp;
+	const struct argnod	*ap;
+	Shbltin_f		fp;
+	for(ap = t->com.comset; ap; ap = ap->argnxt.ap)
+		if(!loop_safevar(ap->argval,strcspn(ap->argval,"+=")))
+			return 0;
+	if(!loop_safeargs(t->com.comset) || !loop_safeio(t->com.comio))
+		return 0;
+	if(!np)
+		return !t->com.comarg.ap;	/* assignments and redirections only */
+	if((t->com.comtyp&COMSCAN) && !loop_safeargs(t->com.comarg.ap))
+		return 0;
+#if SHOPT_NAMESPACE
+	if(sh.namespace)
+		return 0;
+#endif /* SHOPT_NAMESPACE */
+	if(np==SYSCONT)
+		return !loop_arg(t,1) && !t->com.comio;
+	/* a function may override a regular built-in */
+	if(!(np = dtsearch(sh.fun_tree,np)) || !is_abuiltin(np))
+		return 0;
+	/* an error in a special built-in exits the shell */
+	if(nv_isattr(np,BLT_SPC) && t->com.comio)
+		return 0;
+	fp = funptr(np);
+	if(fp==b_read)
+		return loop_saferead(t);
+	return fp==b_print || fp==b_printf || fp==b_true || fp==b_false
+		|| fp==b_let || fp==b_test || fp==b_getopts || fp==b_pwd;
+}
+
+static int loop_safe(const Shnode_t *t)
+{
+	const struct regnod *rp;
+	if(!t)
+		return 1;
+	switch(t->tre.tretyp&COMMSK)
+	{
+	    case TCOM:
+		return loop_safecom(t);
+	    case TTIME:
+		return loop_safe(t->par.partre);
+	    case TSETIO:
+		return loop_safeio(t->fork.forkio) && loop_safe(t->fork.forktre);
+	    case TIF:
+		return loop_safe(t->if_.iftre) && loop_safe(t->if_.thtre) && loop_safe(t->if_.eltre);
+	    case TWH:
+		return loop_safe((Shnode_t*)t->wh.whinc) && loop_safe(t->wh.whtre) && loop_safe(t->wh.dotre);
+	    case TLST:
+	    case TAND:
+	    case TORF:
+		return loop_safe(t->lst.lstlef) && loop_safe(t->lst.lstrit);
+	    case TARITH:
+		return t->ar.arcomp && loop_safearith(t->ar.arexpr->argval);
+	    case TFOR:
+		if(t->tre.tretyp&COMSCAN)
+			return 0;	/* 'select' */
+		if(!loop_safevar(t->for_.fornam,strlen(t->for_.fornam)))
+			return 0;
+		if(t->for_.forlst && (t->for_.forlst->comtyp&COMSCAN) && !loop_safeargs(t->for_.forlst->comarg.ap))
+			return 0;
+		return loop_safe(t->for_.fortre);
+	    case TSW:
+		if(!loop_safeargs(t->sw.swarg))
+			return 0;
+		for(rp = t->sw.swlst; rp; rp = rp->regnxt)
+			if(!loop_safeargs(rp->regptr) || !loop_safe(rp->regcom))
+				return 0;
+		return 1;
+	    case TTST:
+		if((t->tre.tretyp&TPAREN)==TPAREN)
+			return loop_safe(t->lst.lstlef);
+		/* the operands of arithmetic comparisons are evaluated when they are run */
+		if((t->tre.tretyp&TBINARY) && ((t->tre.tretyp>>TSHIFT)&TEST_ARITH))
+			return 0;
+		return loop_safeargs(&t->lst.lstlef->arg) && (!(t->tre.tretyp&TBINARY) || loop_safeargs(&t->lst.lstrit->arg));
+	}
+	return 0;
+}
+
+/*
+ * Check whether the 'while' loop <t> may let 'read' buffer standard input
+ */
+static int loop_readahead(const Shnode_t *t)
+{
+	const Shnode_t	*tt = t->wh.whtre;
+	Namval_t	*np, fake;
+	int		i;
+	if(sh_isoption(SH_XTRACE) || sh.st.trap[SH_DEBUGTRAP] || sh.st.trap[SH_ERRTRAP])
+		return 0;
+	if(sh.subshell || sh.discfun || sh_isoption(SH_INTERACTIVE) || sh_isoption(SH_ERREXIT) || sh_isoption(SH_NOUNSET))
+		return 0;
+	for(i = 1; i < sh.st.trapmax; i++)
+		if(sh.st.trapcom[i])
+			return 0;
+	/* user-defined arithmetic functions */
+	fake.nvname = ".sh.math.";
+	np = (Namval_t*)dtprev(sh.fun_tree,&fake);
+	if((np = (Namval_t*)dtnext(sh.fun_tree,np)) && strncmp(np->nvname,".sh.math.",9)==0)
+		return 0;
+	/* the condition must be a lone 'read' from standard input */
+	if((tt->tre.tretyp&(COMMSK|COMSCAN))!=TCOM || tt->com.comio || !(np = (Namval_t*)tt->com.comnamp)
+	|| !(np = dtsearch(sh.fun_tree,np)) || funptr(np)!=b_read)
+		return 0;
+	loop_node = t;
+	return loop_safecom(tt) && loop_safe(t->wh.dotre);
+}
+#endif /* SHOPT_OPTIMIZE */
+
 /*
  * Main execution function: execute any type of command.
  */
@@ -897,6 +1653,7 @@ int sh_exec(const Shnode_t *t, int flags)
 		&& !sh_isoption(SH_XTRACE)
 		&& !sh.st.trap[SH_DEBUGTRAP])
 		{
+			prof_cmd(t->com.comline);
 			/* Execute optimized basic versions of the builtins */
 			if(fp==b_false)
 				++sh.exitval;
@@ -943,6 +1700,7 @@ int sh_exec(const Shnode_t *t, int flags)
 			type &= (COMMSK|COMSCAN);
 			sh_stats(STAT_SCMDS);
 			error_info.line = t->com.comline-sh.st.firstline;
+			prof_cmd(t->com.comline);
 			com = sh_argbuild(&argn,&(t->com),flags & ARG_OPTIMIZE);
 			echeck = 1;
 			if(t->tre.tretyp&COMSCAN)
@@ -1512,7 +2270,14 @@ int sh_exec(const Shnode_t *t, int flags)
 				if(com && !job.jobcontrol)
 #endif /* _use_ntfork_tcpgrp */
 				{
-					parent = sh_ntfork(t,com,&jobid,topfd);
+					parent = sh_ntfork(t,com,&jobid,topfd,0);
+					if(parent<0)
+						break;
+				}
+				else if(!com && (com = spawn_argv(t,type)))
+				{
+					/* simple external command in a pipeline or in the background */
+					parent = sh_ntfork(t->fork.forktre,com,&jobid,topfd,type);
 					if(parent<0)
 						break;
 				}
@@ -1993,6 +2758,7 @@ int sh_exec(const Shnode_t *t, int flags)
 			char *cp, *trap, *null_pointer = NULL;
 			int nameref, refresh=1;
 			char *av[5];
+			struct lprog *doprog;
 #if SHOPT_OPTIMIZE
 			int  jmpval = ((struct checkpt*)sh.jmplist)->mode;
 			struct checkpt *buffp = stkalloc(sh.stk,sizeof(struct checkpt));
@@ -2018,6 +2784,7 @@ int sh_exec(const Shnode_t *t, int flags)
 			}
 			np = nv_open(t->for_.fornam, sh.var_tree,NV_NOARRAY|NV_VARNAME|NV_NOREF);
 			nameref = nv_isref(np)!=0;
+			doprog = loop_compile(t->for_.fortre);
 			sh.st.loopcnt++;
 			cp = *args;
 			while(cp && sh.st.breakcnt==0)
@@ -2083,7 +2850,7 @@ int sh_exec(const Shnode_t *t, int flags)
 					av[4] = 0;
 					sh_debug(trap,NULL,NULL,av,0);
 				}
-				sh_exec(t->for_.fortre,flag);
+				loop_exec(doprog,flag);
 				flag &= ~ARG_OPTIMIZE;
 				if(t->tre.tretyp&COMSCAN)
 				{
@@ -2126,6 +2893,7 @@ int sh_exec(const Shnode_t *t, int flags)
 			char always_true;
 			Namval_t *np;
 			Shbltin_f fp;
+			struct lprog *whprog, *doprog, *incprog;
 #if SHOPT_FILESCAN
 			Sfio_t *iop=0;
 			int savein=-1;
@@ -2134,6 +2902,7 @@ int sh_exec(const Shnode_t *t, int flags)
 			int  jmpval = ((struct checkpt*)sh.jmplist)->mode;
 			struct checkpt *buffp = stkalloc(sh.stk,sizeof(struct checkpt));
 			void *optlist = sh.optlist;
+			char savereadahead = sh.readahead;
 			sh.optlist = 0;
 			sh_tclear(t->wh.whtre);
 			sh_tclear(t->wh.dotre);
@@ -2165,6 +2934,13 @@ int sh_exec(const Shnode_t *t, int flags)
 				&& !tt->com.comio			/* no I/O redirections */
 				&& !sh_isoption(SH_XTRACE)
 				&& !sh.st.trap[SH_DEBUGTRAP]);
+			whprog = loop_compile(tt);
+			doprog = loop_compile(t->wh.dotre);
+			incprog = loop_compile((Shnode_t*)t->wh.whinc);
+#if SHOPT_OPTIMIZE
+			if(!sh.readahead && type==TWH && !incprog)
+				sh.readahead = loop_readahead(t);
+#endif /* SHOPT_OPTIMIZE */
 			sh.st.loopcnt++;
 			while(sh.st.breakcnt==0)
 			{
@@ -2176,15 +2952,15 @@ int sh_exec(const Shnode_t *t, int flags)
 				}
 				else
 #endif /* SHOPT_FILESCAN */
-				if(!always_true && (sh_exec(tt,first)==0)!=(type==TWH))
+				if(!always_true && (loop_exec(whprog,first)==0)!=(type==TWH))
 					break;
-				r = sh_exec(t->wh.dotre,first|errorflg);
+				r = loop_exec(doprog,first|errorflg);
 				/* decrease 'continue' level */
 				if(sh.st.breakcnt<0)
 					sh.st.breakcnt++;
 				/* This is for the arithmetic for */
-				if(sh.st.breakcnt==0 && t->wh.whinc)
-					sh_exec((Shnode_t*)t->wh.whinc,first);
+				if(sh.st.breakcnt==0 && incprog)
+					loop_exec(incprog,first);
 				first = 0;
 				errorflg &= ~ARG_OPTIMIZE;
 #if SHOPT_FILESCAN
@@ -2195,6 +2971,7 @@ int sh_exec(const Shnode_t *t, int flags)
 #if SHOPT_OPTIMIZE
 		endwhile:
 			sh_popcontext(buffp);
+			sh.readahead = savereadahead;
 			sh_tclear(t->wh.whtre);
 			sh_tclear(t->wh.dotre);
 			sh_optclear(optlist);
@@ -2228,6 +3005,7 @@ int sh_exec(const Shnode_t *t, int flags)
 			char *trap;
 			char *arg[4];
 			error_info.line = t->ar.arline-sh.st.firstline;
+			prof_cmd(t->ar.arline);
 			arg[0] = "((";
 			if(!(t->ar.arexpr->argflag&ARG_RAW))
 				arg[1] = sh_macpat(t->ar.arexpr,(flags & ARG_OPTIMIZE)|ARG_ARITH);
@@ -2584,6 +3362,7 @@ int sh_exec(const Shnode_t *t, int flags)
 			if(type&TTEST)
 				skipexitset++;
 			error_info.line = t->tst.tstline-sh.st.firstline;
+			prof_cmd(t->tst.tstline);
 			echeck = 1;
 			if((type&TPAREN)==TPAREN)
 			{
@@ -3189,6 +3968,12 @@ static void sh_funct(Namval_t *np,int argn, char *argv[],struct argnod *envlist,
 	struct funenv	fun;
 	char		*fname = nv_getval(SH_FUNNAMENOD);
 	pid_t		pipepid = sh.pipepid;
+#if SHOPT_STATS
+	struct profsample pstart;
+	int		profiling = sh_isoption(SH_CMDPROFILE) && prof.dict;
+	if(profiling)
+		prof_sample(&pstart);
+#endif
 #if !SHOPT_DEVFD
 	Dt_t		*save_fifo_tree = sh.fifo_tree;
 	sh.fifo_tree = NULL;
@@ -3223,6 +4008,14 @@ static void sh_funct(Namval_t *np,int argn, char *argv[],struct argnod *envlist,
 		fun.nref = 0;
 		sh_funscope(argn,argv,0,&fun,execflg);
 	}
+#if SHOPT_STATS
+	if(profiling && prof.dict && prof.pid==sh.current_pid)
+	{
+		struct profsample now;
+		prof_sample(&now);
+		prof_charge(prof_enter(nv_name(np),rp->fname,rp->lineno),&pstart,&now);
+	}
+#endif
 	sh.last_root = nv_dict(DOTSHNOD);
 	nv_putval(SH_FUNNAMENOD,fname,NV_NOFREE);
 	nv_putval(SH_PATHNAMENOD,sh.st.filename,NV_NOFREE);
@@ -3365,19 +4158,64 @@ static void sigreset(int mode)
 	}
 }
 
+/*
+ * Return the argument list of the simple command run by the TFORK node <t>
+ * of type <type> if it can be spawned by sh_ntfork() instead of forking the
+ * shell, otherwise NULL. This is the case for an external command in a pipeline
+ * or in the background that needs no expansions, assignments or redirections
+ * and that cannot observe whether the shell was forked. Job control and process
+ * substitutions always fork, as they need process groups or inherited pipes.
+ */
+static char **spawn_argv(const Shnode_t *t,int type)
+{
+	const Shnode_t	*tp = t->fork.forktre;
+	struct dolnod	*dp;
+	char		*name;
+	if(!(type&(FPIN|FPOU|FAMP)) || (type&(FCOOP|FSHOWME)) || t->fork.forkio)
+		return NULL;
+	if(!tp || (tp->tre.tretyp&(COMMSK|COMSCAN))!=TCOM || tp->com.comset || tp->com.comio || tp->com.comnamp)
+		return NULL;
+	if(!(dp = tp->com.comarg.dp) || dp->dolnum<1)
+		return NULL;
+	if(job.jobcontrol || sh_isstate(SH_MONITOR) || sh_isstate(SH_PROCSUB) || sh_isoption(SH_XTRACE)
+	|| sh_isoption(SH_NOEXEC) || sh.st.trap[SH_DEBUGTRAP] || ((type&FAMP) && sh_isoption(SH_BGNICE)))
+		return NULL;
+#if !SHOPT_DEVFD
+	if(sh.fifo)
+		return NULL;
+#endif /* !SHOPT_DEVFD */
+	name = dp->dolval[dp->dolbot];
+	if(nv_search(name,sh.bltin_tree,0) || nv_search(name,sh.fun_tree,0))
+		return NULL;
+	if(strchr(name,'/'))
+	{
+		if(sh_isoption(SH_RESTRICTED))
+			return NULL;
+		/* an absolute path yields 1; a relative one 0 with the full path on the stack, if executable */
+		if(path_search(name,NULL,3) ? *name!='/' : !*stkptr(sh.stk,PATH_OFFSET))
+			return NULL;
+	}
+	else if(!path_gettrackedalias(name) && (path_search(name,NULL,3) || !*stkptr(sh.stk,PATH_OFFSET)))
+		return NULL;  /* function on FPATH or command not found: let the child report it */
+	return dp->dolval+dp->dolbot;
+}
+
 /*
  * A combined fork/exec for systems with slow fork().
  * Incompatible with job control on interactive shells (job.jobcontrol) if
  * the system does not support posix_spawn_file_actions_addtcsetpgrp_np().
+ * If <flags> contains FPIN, FPOU or FINT, the pipes and the standard input for
+ * background jobs are set up for the command as the forked child would do it.
  */
-static pid_t sh_ntfork(const Shnode_t *t,char *argv[],int *jobid,int topfd)
+static pid_t sh_ntfork(const Shnode_t *t,char *argv[],int *jobid,int topfd,int flags)
 {
 	static pid_t	spawnpid;
 	struct checkpt	*buffp = stkalloc(sh.stk,sizeof(struct checkpt));
 	int		jmpval,jobfork=0;
-	volatile int	scope=0, sigwasset=0;
+	volatile int	scope=0, sigwasset=0, intwasset=0;
 	char		**arge, *path;
 	volatile pid_t	grp = 0;
+	void		(*volatile sigint)(int), (*volatile sigquit)(int);
 	Pathcomp_t	*pp;
 #if _use_ntfork_tcpgrp
 	volatile int	jobwasset=0;
@@ -3391,6 +4229,27 @@ static pid_t sh_ntfork(const Shnode_t *t,char *argv[],int *jobid,int topfd)
 		spawnpid = -1;
 		if(t->com.comio)
 			sh_redirect(t->com.comio,0);
+		if((flags&FINT) && !sh.st.ioset)
+		{
+			/* default std input for & */
+			sh_iosave(0,sh.topfd,NULL);
+			sh_iorenumber(sh_chkopen(e_devnull),0);
+		}
+		if(flags&FPIN)
+		{
+			sh_iosave(0,sh.topfd,NULL);
+			sh_iorenumber(sh.inpipe[0],0);
+			sh.inpipe[0] = -1;
+		}
+		if(flags&FPOU)
+		{
+			/* the reader's end of the pipe must not stay open in the writer */
+			if(fcntl(sh.outpipe[0],F_SETFD,FD_CLOEXEC)>=0)
+				sh.fdstatus[sh.outpipe[0]] |= IOCLEX;
+			sh_iosave(1,sh.topfd,NULL);
+			sh_iorenumber(sh.outpipe[1],1);
+			sh.outpipe[1] = -1;
+		}
 		error_info.id = *argv;
 		if(t->com.comset)
 		{
@@ -3453,6 +4312,12 @@ static pid_t sh_ntfork(const Shnode_t *t,char *argv[],int *jobid,int topfd)
 		sfsync(NULL);
 		sigreset(0);	/* set signals to ignore */
 		sigwasset++;
+		if(flags&FINT)
+		{
+			sigint = signal(SIGINT,SIG_IGN);
+			sigquit = signal(SIGQUIT,SIG_IGN);
+			intwasset++;
+		}
 	        /* find first path that has a library component */
 		for(pp=path_get(argv[0]); pp && !pp->lib ; pp=pp->next);
 		job_fork(-1);
@@ -3531,6 +4396,11 @@ static pid_t sh_ntfork(const Shnode_t *t,char *argv[],int *jobid,int topfd)
 #endif /* _use_ntfork_tcpgrp */
 	if(sigwasset)
 		sigreset(1);	/* restore ignored signals */
+	if(intwasset)
+	{
+		signal(SIGINT,sigint);
+		signal(SIGQUIT,sigquit);
+	}
 	if(scope)
 	{
 		sh_unscope();
@@ -3538,13 +4408,15 @@ static pid_t sh_ntfork(const Shnode_t *t,char *argv[],int *jobid,int topfd)
 		if(jmpval==SH_JMPSCRIPT)
 			nv_setlist(t->com.comset,NV_EXPORT|NV_IDENT|NV_ASSIGN,0);
 	}
-	if(t->com.comio && (jmpval || spawnpid<=0) && sh.topfd > topfd)
+	if((t->com.comio && (jmpval || spawnpid<=0) || (flags&(FINT|FPIN|FPOU))) && sh.topfd > topfd)
 		sh_iorestore(topfd,jmpval);
+	if(jmpval==SH_JMPSCRIPT && (flags&FPOU))
+		sh_close(sh.outpipe[0]);  /* forked child running a script without #! */
 	if(jmpval>SH_JMPCMD)
 		siglongjmp(*sh.jmplist,jmpval);
 	if(spawnpid>0)
 	{
-		_sh_fork(spawnpid,0,jobid);
+		_sh_fork(spawnpid,flags,jobid);
 		job_fork(spawnpid);
 		if(grp==1)
 			job.curpgid = spawnpid;
@@ -319,5 +319,23 @@ chmod +x bad_func  # bug only triggered if file is executable
 (FPATH=$PWD; alias -t bad_func 2>/dev/null; typeset -f bad_func >/dev/null)
 (($? > 0)) || err_exit "'hash'/'alias -t' autoloads function"
 
+# ======
+# Aliases are kept in a hash table, but must still be listed in sorted order
+got=$(
+	unalias -a
+	typeset -i i
+	for ((i=0; i<1000; i++))
+	do	alias a$((i*7919%1000))=$i
+	done
+	alias
+)
+exp=$(LC_ALL=C; typeset -i i; for ((i=0; i<1000; i++)); do print "a$((i*7919%1000))=$i"; done | sort)
+[[ $got == "$exp" ]] || err_exit "aliases not listed in sorted order" \
+	"(got $(printf %q "$got" | head -c 500))"
+got=$(hash -r; PATH=/bin:/usr/bin; hash tr sort ls cat; hash)
+exp=$(printf '%s\n' cat=$(whence -p cat) ls=$(whence -p ls) sort=$(whence -p sort) tr=$(whence -p tr))
+[[ $got == "$exp" ]] || err_exit "tracked aliases not listed in sorted order" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
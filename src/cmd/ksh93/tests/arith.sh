@@ -1134,5 +1134,74 @@ else	typeset -ui i
 	unset i
 fi
 
+# ======
+# Constant subexpressions are folded at compile time; the results must not change
+for e in '1+2*3=7' '-(1?2:3)=-2' '(1?2:3)+4=6' '1<<4|1=17' '7/2=3' '7%3=1' '-7/2=-3' '-7%3=-1' '~5=-6' '!0=1' \
+	'3-2-1=0' '2*3+4*5=26' '1<2 && 3>2=1' '(1,2)+3=5' '1.5+2=3.5' \
+	'2**10=1024' '4==4=1' '4!=4=0' '1>=2=0' '0 ? 1/0 : 2=2' '0 && 1/0=0' '-(-0)=0'
+do	exp=${e##*=}
+	e=${e%=*}
+	got=$(( $e ))
+	[[ $got == "$exp" ]] || err_exit "constant expression $e (expected $(printf %q "$exp"), got $(printf %q "$got"))"
+	((got = $e))
+	[[ $got == "$exp" ]] || err_exit "constant expression $e in ((...)) (expected $(printf %q "$exp"), got $(printf %q "$got"))"
+done
+got=$(set +x; eval '((1/0))' 2>&1)
+[[ $got == *'divide by zero'* ]] || err_exit "division by zero not detected in constant expression (got $(printf %q "$got"))"
+got=$(set +x; eval ': $((1.5 & 1))' 2>&1)
+[[ $got == *'invalid floating point operation'* ]] || err_exit "float operand of & not detected in constant expression (got $(printf %q "$got"))"
+
+# Integer values assigned to untyped variables are formatted without a floating point conversion
+unset x got
+for e in 1 -1 0 -0 '10**17' '10**17-1' '10**18' '10**18-1' '-(10**17)' '2**62' 1.5 '1/3.' '2**63' '-(2**63)'
+do	((x = $e))
+	got+=" $x"
+done
+exp=' 1 -1 0 -0 100000000000000000 99999999999999999 1e+18 999999999999999999 -100000000000000000'
+exp+=' 4.6116860184273879e+18 1.5 0.333333333333333333 9.22337203685477581e+18 -9.22337203685477581e+18'
+[[ $got == "$exp" ]] || err_exit "arithmetic assignment to untyped variable" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+unset x got exp
+
+# ======
+# Expressions evaluated at run time are cached after being compiled; make sure the cache does not return stale results
+e='x + 1'
+x=1
+function f { typeset x=10; print $(( $e )); }
+got="$(( $e )) $(f) $(( $e ))"
+[[ $got == '2 11 2' ]] || err_exit "cached expression does not use local variable (expected '2 11 2', got '$got')"
+unset x
+got=$(( $e ))
+x=5
+got+=" $(( $e ))"
+[[ $got == '1 6' ]] || err_exit "cached expression does not see unset and reassigned variable (expected '1 6', got '$got')"
+unset x e
+function .sh.math.cachetest n { .sh.value=n+1; }
+e='cachetest(1)'
+got=$(( $e ))
+function .sh.math.cachetest n { .sh.value=n+2; }
+got+=" $(( $e ))"
+[[ $got == '2 3' ]] || err_exit "cached expression does not use redefined math function (expected '2 3', got '$got')"
+unset -f .sh.math.cachetest
+unset e
+got=$(let 'x=010'; print $x; set -o letoctal; let 'x=010'; print $x)
+[[ $got == $'10\n8' ]] || err_exit "cached let expression ignores letoctal (got $(printf %q "$got"))"
+y='z * 2' z=3
+got="$(( y + 1 )) $(( y + 1 ))"
+[[ $got == '7 7' ]] || err_exit "recursive cached expression (expected '7 7', got '$got')"
+unset y z
+typeset -a arr
+for ((i=0; i<3; i++)); do arr[i%2+1]=$i; done
+[[ ${arr[@]} == '2 1' ]] || err_exit "cached arithmetic subscript (expected '2 1', got '${arr[*]}')"
+unset arr i
+got=$(set +x; e='1 +'; for i in 1 2; do (eval ': $(( $e ))') 2>&1; done)
+[[ $got == *'more tokens expected'*'more tokens expected'* ]] || err_exit "error in cached expression not reported each time (got $(printf %q "$got"))"
+if	[[ -n $(LC_ALL=de_DE.UTF-8 "$SHELL" -c 'print $((1,5+1))' 2>/dev/null) ]]
+then	got=$(e='1.5 + 1'; print $(( $e )); LC_ALL=de_DE.UTF-8; e='1,5 + 1'; print $(( $e )))
+	[[ $got == $'2.5\n2,5' ]] || err_exit "cached expression ignores locale change (got $(printf %q "$got"))"
+fi
+got=$(PAR=( (BEG=a) (BEG=b) ); for P in 0 1; do for C in 0 1; do print -n "${PAR[P].BEG}"; done; done)
+[[ $got == aabb ]] || err_exit "compound array element with cached subscript not looked up again (expected aabb, got $got)"
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -946,5 +946,61 @@ exp='typeset -A -i yarr=([foo=bar]=123 [lorem=ipsum]=456)'
 [[ $got == "$exp" ]] || err_exit "associative array index containing '=' misparsed in declaration command" \
 	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
 
+# ======
+# Associative arrays are hashed, but are still listed in sorted order
+got=$(
+	typeset -A A=([zeta]=1 [alpha]=2 [mid]=3 [beta]=4 [z]=5 ['a b']=6)
+	print -r -- "${!A[@]}"
+	print -r -- "${A[@]}"
+	A[aa]=7
+	unset A[beta]
+	typeset -p A
+	function f { typeset -A A=([q]=1 [b]=2); A[m]=3; print -r -- "${!A[@]}"; }
+	f
+	typeset -A C=([x]=(a=1 b=2) [c]=(a=3))
+	print -r -- "${!C[@]}"
+)
+exp=$'a b alpha beta mid z zeta\n6 2 4 3 5 1\ntypeset -A A=([\'a b\']=6 [aa]=7 [alpha]=2 [mid]=3 [z]=5 [zeta]=1)\nb m q\nc x'
+[[ $got == "$exp" ]] || err_exit "associative array elements not listed in sorted order" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(
+	typeset -A A
+	for ((i=0; i<1000; i++)); do A[k$((i*7919%1000))]=$i; done
+	unset A[k500]
+	set -- "${!A[@]}"
+	print $# ${#A[@]} $1 ${@: -1}
+	for k in "${!A[@]}"; do unset "A[$k]"; done
+	print ${#A[@]}
+)
+exp=$'999 999 k0 k999\n0'
+[[ $got == "$exp" ]] || err_exit "large associative array listed or unset incorrectly" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+# ======
+# Large numeric indexed arrays keep their values in packed storage
+got=$(
+	integer -a a
+	for ((i=0; i<600; i++)); do a[i]=i*2; done
+	print ${a[300]} ${a[599]} ${#a[@]}
+	unset a[300]
+	print ${#a[@]} ${a[300]-unset}
+	a[300]=7 a[301]+=5
+	print ${a[300]} ${a[301]}
+	typeset -F2 a
+	print ${a[302]}
+	b=( "${a[@]}" )
+	print ${#b[@]} ${b[599]}
+	typeset -A a
+	print ${a[599]}
+	float -a d
+	for ((i=0; i<300; i++)); do d[i]=i/2.0; done
+	print ${d[299]}
+	function f { integer -a c; for ((i=0; i<300; i++)); do c[i]=i; done; print ${c[299]}; }
+	f; f
+)
+exp=$'600 1198 600\n599 unset\n7 607\n604.00\n600 1198.00\n1198.00\n149.5\n299\n299'
+[[ $got == "$exp" ]] || err_exit "large numeric indexed array gives wrong values" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
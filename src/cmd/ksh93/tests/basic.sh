@@ -1065,6 +1065,91 @@ do
 done
 unset testcode
 
+# ======
+# Parse tree cache for dot scripts and autoloaded functions
+mkdir -m 700 "$tmp/parsecache" "$tmp/parsecache_fpath"
+cat >$tmp/parsecache.sh <<\EOF
+integer n=0
+for i in 1 2 3; do ((n+=i)); done
+function pc_fn { print "pc_fn $1 ${.sh.file##*/} $LINENO"; }
+print "n=$n"
+EOF
+print 'function pc_auto { print "pc_auto $*"; }' >$tmp/parsecache_fpath/pc_auto
+exp=$'n=6\npc_fn x parsecache.sh 3\npc_auto y'
+for i in 1 2
+do	got=$(KSH_PARSECACHE=$tmp/parsecache FPATH=$tmp/parsecache_fpath "$SHELL" -c ". $tmp/parsecache.sh; pc_fn x; pc_auto y" 2>&1)
+	[[ $got == "$exp" ]] || err_exit "parse tree cache: wrong output on run $i" \
+		"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+done
+set -- "$tmp"/parsecache/*.kshc
+(($# == 2)) || err_exit "parse tree cache: expected 2 cache files, got $#"
+print 'print changed' >>$tmp/parsecache.sh
+exp=$'n=6\nchanged'
+got=$(KSH_PARSECACHE=$tmp/parsecache "$SHELL" -c ". $tmp/parsecache.sh" 2>&1)
+[[ $got == "$exp" ]] || err_exit "parse tree cache: changed file not reparsed" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+print 'if then' >$tmp/parsecache.sh
+got=$(KSH_PARSECACHE=$tmp/parsecache "$SHELL" -c ". $tmp/parsecache.sh" 2>&1)
+[[ $got == *'syntax error'* ]] || err_exit "parse tree cache: syntax error not reported (got $(printf %q "$got"))"
+set -- "$tmp"/parsecache/*
+(($# == 2)) || err_exit "parse tree cache: temporary file left after syntax error"
+set --
+
+# ======
+# Loop bodies are lowered to a list of steps; ((...)) commands in them are run directly.
+# Make sure that this does not change how they behave.
+got=$(for i in 1 2 3; do ((x=i)); ((i==2)) && break; ((y=i)); done; print $x $y)
+[[ $got == '2 1' ]] || err_exit "break in lowered loop body (expected '2 1', got $(printf %q "$got"))"
+got=$(integer i n=0; for ((i=0; i<5; i++)); do ((i%2)) && continue; ((n++)); done; print $n)
+[[ $got == 3 ]] || err_exit "continue in lowered loop body (expected 3, got $(printf %q "$got"))"
+integer i=0
+while ((i++ < 3)); do ((0)); done
+(($? == 1)) || err_exit "exit status of lowered while loop (expected 1, got $?)"
+exp=$'(( j=i ))\n(( i++ ))\n((  i<2 ))\n(( j=i ))'
+got=$(set +x; trap 'print -r -- "${.sh.command}"' DEBUG; for ((i=0; i<2; i++)); do ((j=i)); done 2>&1; trap - DEBUG)
+[[ $got == *"$exp"* ]] || err_exit "DEBUG trap not run for ((...)) in loop body" \
+	"(expected match of *$(printf %q "$exp")*, got $(printf %q "$got"))"
+got=$(PS4='+ '; set -x; for i in 1; do ((j=2)); done 2>&1)
+[[ $got == *'+ ((j=2))'* ]] || err_exit "xtrace output missing for ((...)) in loop body (got $(printf %q "$got"))"
+exp='line 3: 1/0: divide by zero'
+got=$("$SHELL" -c 'for i in 1
+do	((j=1))
+	((1/0))
+done' 2>&1)
+[[ $got == *"$exp" ]] || err_exit "wrong error message in loop body (expected match of *$(printf %q "$exp"), got $(printf %q "$got"))"
+got=$("$SHELL" -c 'trap "print USR1" USR1; for i in 1 2; do ((i==1)) && kill -s USR1 $$; ((j=i)); done; print end' 2>&1)
+[[ $got == $'USR1\nend' ]] || err_exit "trap not run in lowered loop body (got $(printf %q "$got"))"
+
+# ======
+# External commands in pipelines and in the background may be spawned instead of forking the shell
+cat=$(whence -p cat) echo=$(whence -p echo) sleep=$(whence -p sleep) false=$(whence -p false) true=$(whence -p true)
+exp='ONE'
+got=$("$SHELL" -c "$echo one | $cat | tr a-z A-Z | $cat" 2>&1)
+[[ $got == "$exp" ]] || err_exit "wrong output from pipeline of external commands" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+if	((SHOPT_SPAWN && SHOPT_STATS))
+then	exp='4 0'
+	got=$("$SHELL" -c "$true; s=\${.sh.stats.spawns}; $echo a | $cat | $cat >/dev/null; $true & wait; echo \$((\${.sh.stats.spawns}-s)) \${.sh.stats.forks}" 2>&1)
+	[[ $got == "$exp" ]] || err_exit "external commands in pipeline or background forked the shell" \
+		"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+	# expansions must be done in the child, so these still fork, except as the last element of a pipeline
+	exp='1 2'
+	got=$("$SHELL" -c "f=/dev/null; s=\${.sh.stats.spawns}; $cat \"\$f\" | $cat >/dev/null; $cat \"\$f\" & wait; echo \$((\${.sh.stats.spawns}-s)) \${.sh.stats.forks}" 2>&1)
+	[[ $got == "$exp" ]] || err_exit "external commands with expanded arguments in pipeline or background" \
+		"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+fi
+got=$(set -o pipefail; "$false" | "$true" | "$true"; echo $?; "$true" | "$false" | "$true"; echo $?)
+[[ $got == $'1\n1' ]] || err_exit "pipefail with spawned pipeline elements (got $(printf %q "$got"))"
+got=$(print data | "$SHELL" -c "$cat & wait")
+[[ $got == '' ]] || err_exit "background command does not read from /dev/null (got $(printf %q "$got"))"
+got=$("$SHELL" -c "$sleep .2 & kill -s INT \$!; wait \$!; echo \$?")
+[[ $got == 0 ]] || err_exit "background command does not ignore SIGINT (got $(printf %q "$got"))"
+got=$("$SHELL" -c "$cat /dev/zero 2>/dev/null | head -c 3 | wc -c")
+(( got == 3 )) || err_exit "pipeline with spawned writer does not terminate properly (got $(printf %q "$got"))"
+got=$("$SHELL" -c "$false & p=\$!; wait \$p; echo \$? \${p:+set}")
+[[ $got == '1 set' ]] || err_exit "\$! or exit status wrong for spawned background command (got $(printf %q "$got"))"
+unset cat echo sleep false true
+
 # ======
 # checks for tests run in parallel (see near the top)
 wait "$parallel_1" || err_exit "$( < $tmp/parallel_1) is not foobar"
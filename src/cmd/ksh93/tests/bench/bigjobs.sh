@@ -0,0 +1,67 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#             Copyright (c) 2026 Contributors to ksh 93u+m             #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+#                  Martijn Dekker <martijn@inlv.org>                   #
+#                                                                      #
+########################################################################
+
+#
+# Benchmark launching and reaping many background jobs, which must take
+# linear time. Jobs, processes and saved exit statuses used to be looked up
+# in linked lists, and every child process freed all of its parent's jobs,
+# so the last jobs took much longer to launch than the first.
+# This is not part of the regression tests; run it by hand:
+#
+#	ksh tests/bench/bigjobs.sh [-n count] [ksh]
+#
+# <count> background jobs (default 50000) are launched in <ksh> (default:
+# ksh in $PATH). The wall clock time in seconds taken to launch the first
+# and the last tenth of them is reported, followed by the time taken to
+# reap them all. The exit statuses of the last 100 jobs are checked too.
+#
+
+typeset -i count=50000
+while getopts ':n:' opt
+do	case $opt in
+	n)	count=$OPTARG ;;
+	*)	print -u2 "usage: ${0##*/} [-n count] [ksh]"
+		exit 2 ;;
+	esac
+done
+shift $((OPTIND - 1))
+ksh=${1:-ksh}
+export LC_ALL=C
+
+"$ksh" -c '
+typeset -i n=$1 i e
+typeset -F3 t0 t1 t2 t3 t4
+typeset -a pid
+t0=SECONDS
+for ((i=0; i<n; i++))
+do	exit $((i%7)) &
+	((i >= n-100)) && pid[i]=$!
+	if	((i == n/10))
+	then	t1=SECONDS
+	elif	((i == n-n/10))
+	then	t2=SECONDS
+	fi
+done
+t3=SECONDS
+wait
+t4=SECONDS
+for ((i=n-100; i<n; i++))
+do	wait "${pid[i]}"
+	((e=$?, e==i%7)) || print "job $i: expected exit status $((i%7)), got $e"
+done
+printf "%-40s %10.3f\n" "first $((n/10)) of $n jobs launched" $((t1-t0)) \
+	"last $((n/10)) of $n jobs launched" $((t3-t2)) \
+	"all $n jobs reaped" $((t4-t3))
+' bigjobs "$count"
@@ -0,0 +1,76 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#             Copyright (c) 2026 Contributors to ksh 93u+m             #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+#                  Martijn Dekker <martijn@inlv.org>                   #
+#                                                                      #
+########################################################################
+
+#
+# Benchmark the lazy DFA in libast regex against the backtracking matcher.
+# This is not part of the regression tests; run it by hand:
+#
+#	ksh tests/bench/regdfa.sh [-n count] [ksh]
+#
+# Each benchmark is run in a separate <ksh> (default: ksh in $PATH), once
+# with _AST_regex_dfa=0 in the environment, which makes regex use the
+# backtracking matcher only, and once with the DFA. The CPU time in seconds
+# of the matches only (not of building the subject) is reported for both,
+# or the signal that killed <ksh> (the backtracking matcher recurses for
+# each repetition and may run out of stack on long subjects).
+#
+# <count> is the number of times each match is repeated (default 20). The
+# loop of short matches runs <count> times 10000 iterations, and the match
+# that backtracks exponentially is done once.
+#
+
+typeset -i count=20
+while getopts ':n:' opt
+do	case $opt in
+	n)	count=$OPTARG ;;
+	*)	print -u2 "usage: ${0##*/} [-n count] [ksh]"
+		exit 2 ;;
+	esac
+done
+shift $((OPTIND - 1))
+ksh=${1:-ksh}
+export LC_ALL=C
+
+# run the benchmark script $2 with each engine and print both CPU times
+function bench
+{
+	typeset title=$1 script=$2 bt dfa
+	typeset -i e
+	bt=$(exec 2>/dev/null; _AST_regex_dfa=0 "$ksh" -c "$script" 2>&1)
+	((e=$?, e > 256)) && bt=SIG$(kill -l $e)
+	dfa=$(exec 2>/dev/null; "$ksh" -c "$script" 2>&1)
+	((e=$?, e > 256)) && dfa=SIG$(kill -l $e)
+	printf '%-40s %10s %10s\n' "$title" "$bt" "$dfa"
+}
+
+# a 4 MiB subject string of the letters a-j, without digits
+typeset big='typeset s=abcdefghij; while ((${#s} < 4*1024*1024)); do s+=$s; done'
+# time the matches only
+typeset timed='TIMEFORMAT=%3U; typeset -i i; time for ((i=0; i<'$count'; i++)); do'
+typeset timed_short='TIMEFORMAT=%3U; typeset -i i; time for ((i=0; i<'$count'*10000; i++)); do'
+
+printf '%-40s %10s %10s\n' "benchmark ($count matches)" backtrack dfa
+for pat in '*@(ij|jk)' '*[0-9]*' '*@(foo|bar)[0-9]*' '*(a|b|c|d|e|f|g|h|i|j)z'
+do	bench "case 4 MiB in $pat" "$big; $timed case \$s in $pat) ;; esac; done"
+done
+for pat in '*@(ij|jk)' '*(a|b|c|d|e|f|g|h|i|j)z'
+do	bench "[[ 4 MiB == $pat ]]" "$big; $timed [[ \$s == $pat ]]; done"
+done
+bench "\${4 MiB//~(E)[0-9]+/x}" "$big; $timed : \${s//~(E)[0-9]+/x}; done"
+bench 'case 26 a in *(a|aa)*(a|aa)b (once)' "s=aaaaaaaaaaaaaaaaaaaaaaaaaa; TIMEFORMAT=%3U; time case \$s in *(a|aa)*(a|aa)b) ;; esac"
+bench 'short case/[[ ]] matches' "w=bar22; $timed_short
+	case \$w in @(foo|bar|baz)+([0-9])) ;; esac
+	[[ \$w == @(qu|ba)@(ux|r|z)* ]]
+	done"
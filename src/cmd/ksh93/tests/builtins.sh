@@ -1467,6 +1467,24 @@ got="$($SHELL -i "$hist_error_leak" 2>&1)"
 [[ $exp == "$got" ]] || err_exit "file descriptor leak after substitution error in hist builtin" \
 	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
 
+# Searching the history must find the same commands when signatures are used to skip commands
+cat >$tmp/hist_search.sh <<-'EOF'
+	print -r alpha one
+	print -r beta two
+	print -r alphabet three
+	print -r gamma
+	hist -ln 'print -r alpha' 'print -r alpha'
+	hist -ln 'print -r b' 'print -r b'
+	hist -ln 'print -r x' 'print -r x' 2>&1
+	hist -ln 'print -r alpha' 'print -r alpha'
+	hist -ln 'print -r alphabet' 'print -r g'
+EOF
+exp=$'alpha one\nbeta two\nalphabet three\ngamma\n\tprint -r alphabet three\n\tprint -r beta two\n'
+exp+=$'hist_search.sh: hist: print -r x: not found\n\tprint -r alphabet three\n\tprint -r alphabet three\n\tprint -r gamma'
+got=$(cd "$tmp" && HISTFILE=$tmp/hist_search.hist "$SHELL" -i hist_search.sh 2>&1)
+[[ $got == "$exp" ]] || err_exit "hist does not find the right commands" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
 fi # !SHOPT_SCRIPTONLY
 
 # ======
@@ -1748,5 +1766,50 @@ got=$(set +x; { (ulimit -c 0; set --state=foo); } 2>&1)
 let "(e=$?) == 2" || err_exit "crash on unexpected option value" \
 	"(got status $e$( ((e>128)) && print -n /SIG && kill -l "$e"), $(printf %q "$got"))"
 
+# ======
+# mapfile
+
+got=$(printf 'a\nb b\n\nc\\d\nlast' | { mapfile; typeset -p MAPFILE; })
+exp="typeset -a MAPFILE=($'a\\n' $'b b\\n' $'\\n' $'c\\\\d\\n' last)"
+[[ $got == "$exp" ]] || err_exit "mapfile" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(printf 'a\nb\nc\nd\ne\n' | { mapfile -t -s 1 -n 2 arr; typeset -p arr; read line; print "rest=$line"; })
+exp=$'typeset -a arr=(b c)\nrest=d'
+[[ $got == "$exp" ]] || err_exit "mapfile -t -s 1 -n 2 reads the wrong lines or too much input" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(printf 'a\0b\0c' | { mapfile -d '' -t arr; typeset -p arr; })
+exp='typeset -a arr=(a b c)'
+[[ $got == "$exp" ]] || err_exit "mapfile -d ''" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(arr=(x y); printf '1:2:' | { mapfile -d : -O 3 arr; typeset -p arr; })
+exp='typeset -a arr=([0]=x [1]=y [3]=1: [4]=2:)'
+[[ $got == "$exp" ]] || err_exit "mapfile -d : -O 3" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(arr=(x y); mapfile arr </dev/null; typeset -p arr; print ${#arr[@]})
+exp=$'typeset -a arr\n0'
+[[ $got == "$exp" ]] || err_exit "mapfile with no input does not leave an empty indexed array" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(typeset -A arr=([x]=y); print z | mapfile arr 2>&1; print $?; typeset -p arr)
+exp=$'*: mapfile: arr: not an indexed array\n1\ntypeset -A arr=(\\[x]=y)'
+[[ $got == $exp ]] || err_exit "mapfile into an associative array" \
+	"(expected match of $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(seq 7 | { mapfile -t -C 'print cb' -c 3 arr; print ${#arr[@]}; })
+exp=$'cb 2 3\ncb 5 6\n7'
+[[ $got == "$exp" ]] || err_exit "mapfile -C -c" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+# lines spanning buffer windows, read from a file and from a pipe
+integer i
+for ((i=0; i<20000; i++))
+do	print -r -- "line $i ${ printf %0$((i%3==0 ? i%9000 : 3))d 0; }"
+done > $tmp/mapfile.txt
+exp=$(cat $tmp/mapfile.txt)
+got=$(mapfile -t -u 3 arr 3<$tmp/mapfile.txt; printf '%s\n' "${arr[@]}")
+[[ $got == "$exp" ]] || err_exit "mapfile -u from a file loses or corrupts lines"
+got=$(cat $tmp/mapfile.txt | { mapfile -C : -c 1 arr; printf '%s' "${arr[@]}"; })
+[[ $got == "$exp" ]] || err_exit "mapfile with a callback from a pipe loses or corrupts lines"
+got=$(set +x; mapfile -O 0 arr <&- 2>&1; print "status $?")
+[[ $got == *'mapfile: '*'status 1' ]] || err_exit "mapfile on a closed file descriptor" \
+	"(got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -195,5 +195,68 @@ got=$(set +x; eval '
 [[ $got == "$exp" ]] || err_exit "spurious syntax error in case with extended expression" \
 	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
 
+# ======
+# a case statement with more patterns than fit in the initial pattern cache
+# should not compile its patterns again on every iteration
+got=$("$SHELL" -c '
+	for ((i=0; i<400; i++))
+	do	case w$((i%20)) in
+		a*1) ;; b*2) ;; c*3) ;; d*4) ;; e*5) ;; f*6) ;; g*7) ;; h*8) ;; i*9) ;; j*10) ;;
+		k*1) ;; l*2) ;; m*3) ;; n*4) ;; o*5) ;; p*6) ;; q*7) ;; r*8) ;; s*9) ;; w*@(19)) n=$((n+1)) ;;
+		esac
+	done
+	print $n ${.sh.stats.re_compiles}
+' 2>&1)
+if	[[ -v .sh.stats.re_compiles ]]
+then	[[ ${got% *} == 20 && ${got#* } -lt 40 ]] || err_exit "case patterns recompiled in loop (got $(printf %q "$got"))"
+else	[[ ${got% *} == 20 ]] || err_exit "case with 20 patterns in loop (got $(printf %q "$got"))"
+fi
+
+# ======
+# literal patterns with a leading and/or trailing * are matched without regex
+got=$("$SHELL" -c '
+	for f in app.log prod-1 x.txt prod-2.log .log prod- lo
+	do	case $f in
+		*.txt) r=T ;; prod-*.log) r=PL ;; prod-*) r=P ;; *.log) r=L ;; *o*) r=O ;; *) r=N ;;
+		esac
+		print -n "$r${f#prod}${f%%.log}${f/o/0}|"
+	done
+	print ${.sh.stats.re_compiles}
+' 2>&1)
+exp='Lapp.logappapp.l0g|P-1prod-1pr0d-1|Tx.txtx.txtx.txt|PL-2.logprod-2pr0d-2.log|L.log.l0g|P-prod-pr0d-|Ololol0|'
+[[ ${got%\|*}\| == "$exp" ]] || err_exit "literal case patterns" \
+	"(expected $(printf %q "$exp"), got $(printf %q "${got%\|*}\|"))"
+if	[[ -v .sh.stats.re_compiles ]]
+then	[[ ${got##*\|} == 1 ]] || err_exit "literal case patterns compiled as regex (expected 1 compile, got $(printf %q "${got##*\|}"))"
+fi
+
+# ======
+# ${.sh.regcache} sets the limit on the size of the pattern cache
+got=$("$SHELL" -c 'print ${.sh.regcache}' 2>&1)
+[[ $got == 256 ]] || err_exit "default .sh.regcache (expected 256, got $(printf %q "$got"))"
+exp='4 4 9 4'
+got=$("$SHELL" -c '
+	.sh.regcache=4
+	print -n "${.sh.regcache} $((.sh.regcache)) "
+	(.sh.regcache=9; print -n "${.sh.regcache} ")
+	print ${.sh.regcache}
+' 2>&1)
+[[ $got == "$exp" ]] || err_exit "setting .sh.regcache" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(set +x; "$SHELL" -c '.sh.regcache=-1; print end' 2>&1)
+[[ $got == *': -1: bad number' ]] || err_exit ".sh.regcache accepts a negative value (got $(printf %q "$got"))"
+if	[[ -v .sh.stats.re_compiles ]]
+then	got=$("$SHELL" -c '
+		.sh.regcache=4
+		for ((i=0; i<100; i++))
+		do	case w$((i%10)) in
+			a*1) ;; b*2) ;; c*3) ;; d*4) ;; e*5) ;; f*6) ;; g*7) ;; h*8) ;; i*9) ;; w*@(9)) n=$((n+1)) ;;
+			esac
+		done
+		print $n ${.sh.stats.re_compiles}
+	' 2>&1)
+	[[ ${got% *} == 10 && ${got#* } -ge 400 ]] || err_exit ".sh.regcache=4 does not limit the pattern cache (got $(printf %q "$got"))"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -592,5 +592,55 @@ unset null
 ((SHOPT_BRACEPAT)) && test_glob '<*b> <*c>' "*"$null{b,c}
 test_glob '<*>' $null"*"
 
+# ======
+# set -o globcache must not give outdated results
+mkdir gcache gcache/sub gcache/sub/deep
+touch gcache/f1 gcache/f2 gcache/sub/f3 gcache/sub/deep/f4
+ln -s sub gcache/link
+touch -t 200001010000 gcache gcache/sub gcache/sub/deep
+exp=$(set -o globstar -o markdirs; print -r -- gcache/* gcache/**/ gcache/**/f*)
+got=$(set -o globcache -o globstar -o markdirs; print -r -- gcache/* gcache/**/ gcache/**/f*; print -r -- gcache/* gcache/**/ gcache/**/f*)
+[[ $got == "$exp"$'\n'"$exp" ]] || err_exit "globcache changes the result (expected $(printf %q "$exp"$'\n'"$exp"), got $(printf %q "$got"))"
+(
+	set -o globcache
+	test_glob '<gcache/f1> <gcache/f2> <gcache/link> <gcache/sub>' gcache/*
+	test_glob '<gcache/f1> <gcache/f2> <gcache/link> <gcache/sub>' gcache/*
+	touch gcache/f5
+	test_glob '<gcache/f1> <gcache/f2> <gcache/f5> <gcache/link> <gcache/sub>' gcache/*
+	rm gcache/f1
+	test_glob '<gcache/f2> <gcache/f5> <gcache/link> <gcache/sub>' gcache/*
+	touch -t 200001010000 gcache
+	test_glob '<gcache/f2> <gcache/f5> <gcache/link> <gcache/sub>' gcache/*
+	mv gcache/f2 gcache/f6
+	test_glob '<gcache/f5> <gcache/f6> <gcache/link> <gcache/sub>' gcache/*
+	rm gcache/link && mkdir gcache/link
+	test_glob '<gcache/link/> <gcache/sub/>' gcache/*/
+)
+rm -rf gcache
+
+# ======
+# globstar on a wider tree, whose directories may be read ahead, must give the same result as a walk
+mkdir gwide
+for i in 0 1 2 3 4 5 6 7 8 9
+do	for j in a b c d e
+	do	mkdir -p gwide/d$i/$j/sub
+		touch gwide/d$i/$j/f.c gwide/d$i/$j/sub/g.c gwide/d$i/$j/h.h
+	done
+done
+ln -s d0 gwide/link
+function walk
+{
+	typeset f
+	for f in "$1"/*
+	do	[[ -L $f ]] && continue
+		[[ $f == *.c ]] && print -r -- "$f"
+		[[ -d $f ]] && walk "$f"
+	done
+}
+exp=$(walk gwide)
+got=$(set -o globstar; print -r -- gwide/**/*.c | tr ' ' '\n')
+[[ $got == "$exp" ]] || err_exit "globstar on wide tree (expected $(printf %q "$exp"), got $(printf %q "$got"))"
+rm -rf gwide
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -554,5 +554,64 @@ _EOF"; } 2>&1 )
 	"(expected status 0, '$exp';" \
 	"got status $e$( ((e>128)) && print -n /SIG && kill -l "$e"), $(printf %q "$got"))"
 
+# ======
+# The lexer skips runs of ordinary characters in bulk; make sure that here-documents,
+# comments and quoted strings mixing ASCII and multibyte characters across input
+# buffer boundaries are still copied byte for byte.
+bulk=$(printf 'plain ascii text caf\303\251 \342\230\203 more text %s' "$(printf '%0100d' 0)")
+{
+	print "cat <<'EOF'"
+	for ((i=0; i<2000; i++)); do print -r -- "$i $bulk"; done
+	print EOF
+	print "# comment $bulk"
+	print "cat <<EOF"
+	for ((i=0; i<2000; i++)); do print -r -- "$i $bulk \${#v}"; done
+	print EOF
+	print "print -r -- '$bulk' \"$bulk\""
+} >bulk.ksh
+exp=$(
+	for ((i=0; i<2000; i++)); do print -r -- "$i $bulk"; done
+	for ((i=0; i<2000; i++)); do print -r -- "$i $bulk 0"; done
+	print -r -- "$bulk" "$bulk"
+)
+got=$("$SHELL" bulk.ksh 2>&1)
+[[ $got == "$exp" ]] || err_exit "here-documents or quoted strings with multibyte characters are corrupted" \
+	"(expected $(printf %q "$exp" | head -c 200), got $(printf %q "$got" | head -c 200))"
+
+# ======
+# Here-documents are served from anonymous memory-backed files where supported;
+# they must still behave like regular files that can be rewound and read again.
+got=$(
+	exec 3<<-EOF
+	one $((1+1))
+	two
+	EOF
+	read -u3 a
+	exec 3<#((0))
+	print -r -- "$a|$(cat <&3)"
+)
+exp=$'one 2|one 2\ntwo'
+[[ $got == "$exp" ]] || err_exit "here-document file is not seekable" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+v=$(printf '%0200d' 0)
+exp=$(for ((i=0; i<500; i++)); do print -r -- "$i $v"; done)
+got=$(eval "cat <<EOF
+$(for ((i=0; i<500; i++)); do print -r -- "\$((${i})) \$v"; done)
+EOF")
+[[ $got == "$exp" ]] || err_exit "large expanded here-document is corrupted" \
+	"(expected $(printf %q "$exp" | head -c 200), got $(printf %q "$got" | head -c 200))"
+got=$(
+	for ((i=0; i<20; i++)); do
+		{ read x <<-EOF
+		job $i $v
+		EOF
+		[[ $x == "job $i $v" ]] || print -r -- "bad $i: $x"; } &
+		{ read y <<< "str $i"; [[ $y == "str $i" ]] || print -r -- "bad str $i: $y"; } &
+	done
+	wait
+)
+[[ -z $got ]] || err_exit "here-documents in background jobs are corrupted" \
+	"(got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -1064,5 +1064,99 @@ let "$? <= 128" || err_exit "crash on huge RLIMIT_NOFILE"
 (ulimit -n 8; "$SHELL" --version) 2>/dev/null
 let "$? <= 128" || err_exit "crash on tiny RLIMIT_NOFILE"
 
+# ======
+# Large dot scripts are mapped into memory instead of read. Check that they are
+# still read correctly, and that large main scripts, which are parsed one command
+# at a time and so are never mapped, still see their own changes while running.
+pad=$(printf '%0200d' 0)
+{
+	print 'n=0'
+	for ((i=0; i<2000; i++)); do print "((n++)) # $pad"; done
+	print 'print "sum $n"'
+} >bigscript.sh
+exp='sum 2000'
+got=$("$SHELL" bigscript.sh 2>&1)
+[[ e=$? -eq 0 && $got == "$exp" ]] || err_exit "large script file" \
+	"(expected status 0 and $(printf %q "$exp"), got status $e and $(printf %q "$got"))"
+got=$("$SHELL" -c '. ./bigscript.sh' 2>&1)
+[[ e=$? -eq 0 && $got == "$exp" ]] || err_exit "large dot script file" \
+	"(expected status 0 and $(printf %q "$exp"), got status $e and $(printf %q "$got"))"
+{
+	print 'print -r "print appended" >>"$0"'
+	cat bigscript.sh
+} >grow.sh
+exp=$'sum 2000\nappended'
+got=$("$SHELL" grow.sh 2>&1)
+[[ e=$? -eq 0 && $got == "$exp" ]] || err_exit "large script file appending to itself" \
+	"(expected status 0 and $(printf %q "$exp"), got status $e and $(printf %q "$got"))"
+{
+	print 'print start; : >"$0"'
+	cat bigscript.sh
+} >shrink.sh
+got=$("$SHELL" shrink.sh 2>&1)
+[[ e=$? -eq 0 && $got == start* && $got != *sum* ]] || err_exit "large script file truncating itself" \
+	"(expected status 0 and 'start', got status $e$( ((e>128)) && print -n /SIG && kill -l "$e") and $(printf %q "$got"))"
+
+# ======
+# A 'while read' loop that only runs built-ins may read ahead on a pipe,
+# but must not take input from other commands reading the same pipe.
+function lines { integer i; for ((i=1; i<=$1; i++)); do print "line $i"; done; }
+# (A subshell never reads ahead, so run the loops in a separate shell.)
+exp=$(lines 3000)
+got=$(lines 3000 | "$SHELL" -c 'while IFS= read -r x; do print -r -- "$x"; done')
+[[ $got == "$exp" ]] || err_exit "'while read' loop on a pipe loses or corrupts lines"
+got=$(lines 3000 | cat | "$SHELL" -c 'n=0; while read -r x y; do ((n++)); [[ $y == 2999 ]] && print -r -- "$x $y"; done; print $n')
+exp=$'line 2999\n3000'
+[[ $got == "$exp" ]] || err_exit "'while read' loop on a pipe with built-ins only" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(lines 6 | while read x; do "$SHELL" -c 'read y; print -r -- "$y"'; done)
+exp=$'line 2\nline 4\nline 6'
+[[ $got == "$exp" ]] || err_exit "'while read' loop takes input from an external command" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(lines 6 | while read x; do print $("$SHELL" -c 'read y; print -r -- "$y"'); done)
+[[ $got == "$exp" ]] || err_exit "'while read' loop takes input from a command substitution" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(lines 5 | { while read x; do [[ $x == 'line 2' ]] && break; done; cat; })
+exp=$'line 3\nline 4\nline 5'
+[[ $got == "$exp" ]] || err_exit "'while read' loop with 'break' takes input from a later command" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(print $'while read x; do print "got $x"; done\nline 1\nline 2' | "$SHELL" 2>&1)
+exp=$'got line 1\ngot line 2'
+[[ $got == "$exp" ]] || err_exit "'while read' loop in a script read from standard input" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+# Input read ahead is lost if an error leaves the loop and execution resumes after it.
+exp=$'rest:\nline 2\nline 3'
+for cmd in 'set -e; false' 'set -u; : $undef' '((1/0))'
+do	got=$(lines 3 | "$SHELL" -c "(while read x; do $cmd; done) 2>/dev/null; echo rest:; cat")
+	[[ $got == "$exp" ]] || err_exit "'while read' loop left by an error in a subshell ($cmd) takes input from a later command" \
+		"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+done
+got=$(lines 3 | "$SHELL" -c 'trap "echo rest:; cat" ERR; while read x; do false; done; :')
+[[ $got == "$exp" ]] || err_exit "'while read' loop with an ERR trap takes input from the trap" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+# It is also lost if the loop ends before end of file, or if an error exits the shell.
+got=$(printf 'a\nb\nc d\n' | "$SHELL" -c 'while read x; do readonly x; done; echo rest; cat' 2>/dev/null)
+exp=$'rest\nc d'
+[[ $got == "$exp" ]] || err_exit "'while read' loop ended by a 'read' error takes input from a later command" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+exp=$'line 2\nline 3'
+for cmd in 'readonly x; while read x; do :; done; cat' 'typeset -i x; while read x; do :; done; cat' \
+	'readonly r; while read x; do readonly r=1; done' 'readonly r; while read x; do typeset r=1; done' \
+	'readonly r; while read x; do r=1; done' 'while read x; do shift 2; done' \
+	'while read x; do ((n+=x)); done' 'while read x; do y=$((1/0)); done' 'while read x; do : ${y?}; done'
+do	got=$(lines 3 | { "$SHELL" -c "$cmd" 2>/dev/null; cat; })
+	[[ $got == "$exp" ]] || err_exit "'while read' loop ended by an error ($cmd) takes input from a later command" \
+		"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+done
+# Discipline functions may run commands that read the same input.
+got=$(lines 4 | "$SHELL" -c 'function x.set { [[ ${.sh.value} == 1 ]] && cat; }; while read y x; do :; done')
+exp=$'line 2\nline 3\nline 4'
+[[ $got == "$exp" ]] || err_exit "'while read' loop with a 'set' discipline takes input from it" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(lines 4 | "$SHELL" -c 'function z.get { [[ $x == 1 ]] && cat; }; while read y x; do : $z; done')
+[[ $got == "$exp" ]] || err_exit "'while read' loop with a 'get' discipline takes input from it" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+unset -f lines
+
 # ======
 exit $((Errors<125?Errors:125))
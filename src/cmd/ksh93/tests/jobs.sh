@@ -94,5 +94,89 @@ got=$(set +x; ENV=$tmp/profile "$SHELL" -i </dev/null 2>&1)
 [[ -n $got ]] && err_exit "subshell bg job in profile script prints job number (got $(printf %q "$got"))"
 fi # !SHOPT_SCRIPTONLY
 
+# ======
+# 'wait -n' waits for the next job to complete and 'wait -p' reports its process ID.
+got=$(
+	(sleep .4; exit 3) & p1=$!
+	(sleep .1; exit 5) & p2=$!
+	wait -n -p id; print "$? $((id==p2))"
+	wait -n -p id; print "$? $((id==p1))"
+	wait -n -p id; print "$? ${id-unset}"
+)
+exp=$'5 1\n3 1\n127 unset'
+[[ $got == "$exp" ]] || err_exit "'wait -n' with no operands" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(
+	(exit 2) & p1=$!
+	(exit 4) & p2=$!
+	sleep .2
+	wait -n -p id; print "$? $((id==p1))"
+	wait -n -p id; print "$? $((id==p2))"
+)
+exp=$'2 1\n4 1'
+[[ $got == "$exp" ]] || err_exit "'wait -n' does not report already completed jobs, oldest first" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(
+	sleep 1 & p1=$!
+	(sleep .1; exit 6) & p2=$!
+	wait -n -p id "$p1" %2; print "$? $((id==p2))"
+	kill "$p1"
+	wait -n 2>/dev/null; e=$?; print "$e $(kill -l "$e")"
+	wait -n; print $?
+	wait -n %1 "$p1"; print $?
+)
+exp=$'6 1\n271 TERM\n127\n127'
+[[ $got == "$exp" ]] || err_exit "'wait -n' with job operands" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+# a pool of at most 3 jobs at a time, using 'wait -n'
+got=$(
+	typeset -i n=0 i sum=0 max=0
+	for ((i=1; i<=12; i++))
+	do	if	((n >= 3))
+		then	wait -n
+			((sum+=$?, n--))
+		fi
+		(sleep .05; exit $i) &
+		((++n > max)) && max=n
+	done
+	while	((n > 0))
+	do	wait -n
+		((sum+=$?, n--))
+	done
+	wait -n
+	print "$sum $max $?"
+)
+exp='78 3 127'
+[[ $got == "$exp" ]] || err_exit "job pool with 'wait -n'" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+# ======
+# Many background jobs: each must be listed once by 'jobs -l' and keep its exit status after 'wait'.
+# Jobs, processes and saved exit statuses are looked up in hash tables; see tests/bench/bigjobs.sh.
+cat >bigjobs.sh <<\EOF
+typeset -i n=300 i e
+typeset -a pid
+for ((i=0; i<n; i++))
+do	exit $((i%7)) &
+	pid[i]=$!
+done
+jobs -l >jobs.out
+e=$(grep -c . jobs.out)
+((e == n)) || print "'jobs -l' listed $e jobs"
+for ((i=0; i<n; i++))
+do	grep -q "[[:blank:]]${pid[i]}[[:blank:]]" jobs.out || print "job $i not listed"
+done
+wait
+e=$(jobs -l | grep -c .)
+((e == 0)) || print "'jobs -l' listed $e jobs after 'wait'"
+for ((i=0; i<n; i++))
+do	wait "${pid[i]}"
+	((e=$?, e==i%7)) || print "job $i: expected exit status $((i%7)), got $e"
+done
+EOF
+got=$(set +x; "$SHELL" bigjobs.sh 2>&1)
+[[ -z $got ]] || err_exit "many background jobs" \
+	"(got $(printf %q "$got" | head -c 500))"
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -675,5 +675,30 @@ got=$(set --pipefail; "$SHELL" -c 'kill -s PIPE $$' | true; echo $?)
 exp=$(( ${ kill -l PIPE; } + 256 ))
 [[ $got == "$exp" ]] || err_exit "status of signalled process in pipe with pipefail (expected $exp, got $got)"
 
+# ======
+# set -o profile reports time and execution counts per line and per function
+if	(set -o profile) 2>/dev/null
+then	cat >profile.sh <<-'EOF'
+	function f { : one; : two; }
+	set -o profile
+	f; f
+	"${ whence -p true; }"
+	EOF
+	got=$(KSH_PROFILEFILE=profile.out "$SHELL" profile.sh 2>&1)
+	[[ -z $got ]] || err_exit "profile with KSH_PROFILEFILE wrote to stderr (got $(printf %q "$got"))"
+	got=$(awk -F '\t' '{ print $1, $3, $4, $5, $6 }' profile.out 2>&1)
+	exp=$'function f 1 2 0\nline  1 4 0\nline  3 2 0\nline  4 2 1'
+	got=$(print -r -- "$got" | sort)
+	[[ $got == "$exp" ]] || err_exit "profile file has wrong contents" \
+		"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+	got=$("$SHELL" profile.sh 2>&1 >/dev/null)
+	[[ $got == *' f() '*'/profile.sh:1'*'/profile.sh:4'* ]] || err_exit "profile report not written to stderr" \
+		"(got $(printf %q "$got"))"
+	got=$(KSH_PROFILEFILE=profile.out "$SHELL" -c 'set -o profile; set +o profile; : & wait' 2>&1
+		awk -F '\t' '{ print $1, $4, $5, $6 }' profile.out 2>&1)
+	[[ $got == 'line 1 1 0' ]] || err_exit "profile did not stop on set +o profile" \
+		"(got $(printf %q "$got"))"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -1083,5 +1083,116 @@ got=${ $SHELL -c 'print ${!.sh.match} ${!.sh.match[1]} ${!.sh.match[2]}' }
 [[ $exp == "$got" ]] || err_exit "'print \${!.sh.match}' should not print excessive elements" \
 	"(expected ${ printf %q "$exp" }, got ${ printf %q "$got" })"
 
+# ======
+# matches that only need a yes/no answer are done by a lazy DFA, and other
+# matches are first ruled out by it, so nested repetition is not exponential
+got=$(ulimit -t 20 2>/dev/null; "$SHELL" -c '
+	a=aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa
+	case $a in *(a|aa)*(a|aa)b) print -n bad ;; *(a|aa)) print -n ok ;; esac
+	[[ $a == *(a|aa)*(a|aa)b ]] || print -n " ok"
+	[[ $a =~ ^(a|aa)*(a|aa)*b ]] || print -n " ok"
+	[[ ${a//~(E)(a|aa)*(a|aa)*b/x} == "$a" ]] && print -n " ok"
+	x=${a}bx$'\n'${a}b
+	case $x in ~(E)(a|aa)*(a|aa)*b$) print -n " ok" ;; esac
+	case $x in ~(E)^(a|aa)*(a|aa)*b$) print -n " bad" ;; esac
+	case $x in ~(E)(a|aa)*b.$) print -n " bad" ;; esac
+	case $x in ~(E)(a|aa)*b[^a]) print -n " ok" ;; esac
+' 2>&1)
+exp='ok ok ok ok ok ok'
+[[ $got == "$exp" ]] || err_exit "matching nested repetitions" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+# The backtracking matcher used to rule out strings just one repetition long for patterns whose
+# longest literal string follows something else within a repeated group (found by the test below)
+got=$(_AST_regex_dfa=0 "$SHELL" -c '
+	[[ baba == +(?aba) ]] && print -n y
+	[[ baba =~ (.aba)+ ]] && print -n y
+	case xbaba in *+(?aba)) print -n y ;; esac
+	case baba in ~(E)^(.(aba|abb)){1,}$) print -n y ;; esac
+' 2>&1)
+exp=yyyy
+[[ $got == "$exp" ]] || err_exit "strings matching one repetition of a group with a literal string" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+# The DFA must give the same answers as the backtracking matcher, which is used alone with
+# _AST_regex_dfa=0. Compare them on random ERE and shell patterns. With the DFA, each pattern
+# is first matched against a subject long enough to make regnexec() build a DFA for it, which
+# is then also used for the short subjects. (The backtracking matcher is not given the long
+# subject, as it may take exponential time. Nor is a pattern the DFA may decline: outside the
+# C and C.UTF-8 locales, bracket expressions can be collation classes with multi-letter elements.)
+cat >regdiff.sh <<\EOF
+typeset -a sub=('' a b ab ba aa bb aab abb bab bba aaaa abab baba bbbb aabba abbaab)
+typeset long=$(printf 'ab%.0s' {1..40})
+typeset -a eatom=(a b . '[ab]' '[^a]' ab ba) katom=(a b '?' '[ab]' '[!a]' '*' ab)
+typeset -i brackets=0
+[[ ${LC_ALL:-${LC_COLLATE:-$LANG}} == @(|C|POSIX|C.UTF-8|C.utf8) ]] && brackets=1
+function gen
+{
+	typeset -i d=$1
+	typeset x
+	if	((d >= 3 || RANDOM % 3 == 0))
+	then	if	((ere))
+		then	REPLY=${eatom[RANDOM % ${#eatom[@]}]}
+		else	REPLY=${katom[RANDOM % ${#katom[@]}]}
+		fi
+		return
+	fi
+	gen $((d+1))
+	x=$REPLY
+	if	((ere))
+	then	case $((RANDOM % 6)) in
+		0)	gen $((d+1)); REPLY=$x$REPLY ;;
+		1)	gen $((d+1)); REPLY="($x|$REPLY)" ;;
+		2)	REPLY="($x)*" ;;
+		3)	REPLY="($x)+" ;;
+		4)	REPLY="($x)?" ;;
+		5)	REPLY="($x){1,2}" ;;
+		esac
+	else	case $((RANDOM % 6)) in
+		0)	gen $((d+1)); REPLY=$x$REPLY ;;
+		1)	gen $((d+1)); REPLY="@($x|$REPLY)" ;;
+		2)	REPLY="*($x)" ;;
+		3)	REPLY="+($x)" ;;
+		4)	REPLY="?($x)" ;;
+		5)	REPLY="{1,2}($x)" ;;
+		esac
+	fi
+}
+typeset -i i ere
+RANDOM=1
+for ((i = 0; i < 300; i++))
+do	((ere = i % 2))
+	gen 0
+	pat=$REPLY
+	if	((ere))
+	then	((RANDOM % 4)) || pat=^$pat
+		((RANDOM % 4)) || pat=$pat\$
+		pat="~(E)$pat"
+	fi
+	if	[[ $_AST_regex_dfa != 0 ]] && ((brackets)) || [[ $_AST_regex_dfa != 0 && $pat != *\[* ]]
+	then	case $long in $pat) ;; esac
+	fi
+	print -rn -- "$pat "
+	for s in "${sub[@]}"
+	do	case $s in $pat) print -n 1 ;; *) print -n 0 ;; esac
+	done
+	print
+done
+EOF
+exp=$(ulimit -t 20 2>/dev/null; _AST_regex_dfa=0 "$SHELL" regdiff.sh 2>&1)
+got=$(ulimit -t 20 2>/dev/null; "$SHELL" regdiff.sh 2>&1)
+if	[[ $got != "$exp" ]]
+then	integer n=0
+	print -r -- "$exp" >regdiff.exp
+	print -r -- "$got" >regdiff.got
+	while	IFS= read -r e <&3 && IFS= read -r g <&4
+	do	[[ $e == "$g" ]] && continue
+		err_exit "DFA and backtracking matcher differ" "(expected $(printf %q "$e"), got $(printf %q "$g"))"
+		((++n < 5)) || break
+	done 3<regdiff.exp 4<regdiff.got
+	((n)) || err_exit "DFA and backtracking matcher differ" \
+		"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -1219,5 +1219,37 @@ got=$("$SHELL" -c 'x=$(fn(){ return 265; };echo ok|fn); echo exited $?' 2>&1)
 [[ e=$? -eq 0 && $got == "$exp" ]] || err_exit "regression involving SIGPIPE in subshell" \
 	"(expected status 0 and $(printf %q "$exp"), got status $e and $(printf %q "$got"))"
 
+# ======
+# many variables modified in nested virtual subshells must all be restored
+got=$("$SHELL" -c '
+	typeset -a a
+	for ((i=0; i<500; i++)); do eval "v$i=p$i"; a[i]=$i; done
+	x=$(for ((i=0; i<500; i++)); do eval "v$i=c$i"; a[i]=c; done
+		y=$(for ((i=0; i<500; i+=2)); do eval "unset v$i"; done; echo ${v0-u} ${v1-u} ${#a[@]})
+		echo $y $v1 $v2 ${#a[@]} ${a[3]})
+	(for ((i=0; i<500; i++)); do eval "typeset -i v$i=$i"; done)
+	s=0
+	for ((i=0; i<500; i++)); do eval "[[ \$v$i == p$i ]]" && ((s++)); done
+	echo $x $s ${#a[@]} ${a[499]}
+' 2>&1)
+exp='u c1 500 c1 c2 500 c 500 500 499'
+[[ $got == "$exp" ]] || err_exit "variables not restored after subshell modified many of them" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+# ======
+# command substitution output is kept in memory until a command needs a file descriptor
+got=$(printf '%05000d' 1; "${ whence -p echo; }" ext; printf abc)
+exp=$'0000000001ext\nabc'
+[[ ${got:4990} == "$exp" && ${#got} == 5007 ]] || err_exit "large comsub output followed by external command" \
+	"(expected $(printf %q "$exp"), got $(printf %q "${got:4990}") with length ${#got})"
+got=$(printf '%0200000d' 0)
+[[ ${#got} == 200000 ]] || err_exit "large comsub output from built-in lost (got length ${#got})"
+if	[[ -v .sh.stats.subshell_forks ]]
+then	got=$("$SHELL" -c 'f() { printf "%s\n" "$@"; }
+		for ((i=0; i<200; i++)); do x=$(printf "%0*d" 1000 $i; f a b; echo c); done
+		print ${.sh.stats.subshell_forks} ${.sh.stats.forks}')
+	[[ $got == '0 0' ]] || err_exit "comsub running only built-ins and functions forked (got $(printf %q "$got"))"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
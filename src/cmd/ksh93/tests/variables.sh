@@ -1729,6 +1729,31 @@ EOF
 (((e=$?)==0)) || err_exit "crash after unsetting SHLVL" \
 	"(expected status 0, got status $e$( ((e>128)) && print -n /SIG && kill -l "$e"))"
 
+# ======
+# The cached environment list must follow every change to exported variables
+got=$(set +x; "$SHELL" -c '
+	export A=1 B=2
+	env | grep "^[AB]="
+	A=3
+	env | grep "^A="
+	typeset +x A; A=4; export A
+	env | grep "^A="
+	(export A=5; env | grep "^A=")
+	env | grep "^A="
+	function f { typeset -x L=6; env | grep "^L="; A=7 env | grep "^A="; }
+	f
+	env | grep "^L="
+	typeset -i I=8; export I; ((I++))
+	env | grep "^I="
+	unset B
+	env | grep "^B="
+	echo $(export A=10; env | grep "^A=")
+	env | grep "^A="
+' 2>&1)
+exp=$'A=1\nB=2\nA=3\nA=4\nA=5\nA=4\nL=6\nA=7\nI=9\nA=10\nA=4'
+[[ $got == "$exp" ]] || err_exit "environment list not updated correctly" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
 # ======
 # checks for tests run in parallel (see top)
 wait "$parallel_1" || err_exit 'setting TMOUT in a virtual subshell removes its special meaning'
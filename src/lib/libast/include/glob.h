@@ -118,9 +118,11 @@ struct _glob_
 #define GLOB_GROUP	0x10000		/* REG_SHELL_GROUP		*/
 #define GLOB_DCASE	0x20000		/* detect FS case insensitivity	*/
 #define GLOB_FCOMPLETE	0x40000		/* shell file name completion	*/
+#define GLOB_CACHE	0x80000		/* cache directory contents	*/
 
 /* gl_status */
 #define GLOB_NOTDIR	0x0001		/* last gl_dirnext() not a dir	*/
+#define GLOB_ISDIR	0x0002		/* last gl_dirnext() is a dir	*/
 
 /* gl_type return */
 #define GLOB_NOTFOUND	0		/* does not exist		*/
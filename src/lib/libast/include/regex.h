@@ -172,6 +172,15 @@ struct regdisc_s
 	unsigned char*	re_map;		/* external to native ccode map	*/
 };
 
+typedef struct regcachestat_s
+{
+	int		hits;		/* regcache() lookups found	*/
+	int		misses;		/* regcache() lookups compiled	*/
+	int		discards;	/* least recently used discards	*/
+	int		size;		/* current cache size		*/
+	int		max;		/* cache size limit		*/
+} regcachestat_t;
+
 typedef struct regstat_s
 {
 	regflags_t	re_flags;	/* REG_*			*/
@@ -227,6 +236,7 @@ extern int	regrexec(const regex_t*, const char*, size_t, size_t, regmatch_t*, re
 extern regstat_t* regstat(const regex_t*);
 
 extern regex_t*	regcache(const char*, regflags_t, int*);
+extern regcachestat_t* regcachestat(void);
 
 extern int	regsubcomp(regex_t*, const char*, const regflags_t*, int, regflags_t);
 extern int	regsubexec(const regex_t*, const char*, size_t, regmatch_t*);
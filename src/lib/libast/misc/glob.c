@@ -33,17 +33,19 @@
 #include <error.h>
 #include <ctype.h>
 #include <regex.h>
+#include <tmx.h>
 
 /*
  * GLOB_MAGIC is used for sanity checking. Its significant bits must not overlap with those used
  * for flags. If a new GLOB_* flag bit is added to glob.h, these must be adapted accordingly.
  */
-#define GLOB_MAGIC	0xAAA80000	/* 10101010101010000000000000000000 */
-#define GLOB_FLAGMASK	0x0007FFFF	/* 00000000000001111111111111111111 */
+#define GLOB_MAGIC	0xAAA00000	/* 10101010101000000000000000000000 */
+#define GLOB_FLAGMASK	0x000FFFFF	/* 00000000000011111111111111111111 */
 
 #define MATCH_RAW	1
 #define MATCH_MAKE	2
 #define MATCH_META	4
+#define MATCH_DIR	8	/* rescan directory known from d_type */
 
 #define MATCHPATH(g)	(offsetof(globlist_t,gl_path)+(g)->gl_extra)
 
@@ -69,12 +71,122 @@ typedef int (*GL_stat_f)(const char*, struct stat*);
 	unsigned long	gl_starstar; \
 	char*		gl_opt; \
 	char*		gl_pat; \
-	char*		gl_pad[4];
+	void*		gl_pool; \
+	char*		gl_pad[3];
 
 #include <glob.h>
 
 static Stk_t *globstk = stkstd;
 
+/*
+ * GLOB_CACHE directory contents cache
+ * a directory is keyed on its device and inode and its entry list
+ * is reused while its modify and change times stay the same; only
+ * directories left unchanged for GLOB_CACHEAGE are cached so that
+ * changes within one file system timestamp tick are not missed
+ */
+
+#define GLOB_CACHEDIRS	64			/* hash table slots	*/
+#define GLOB_CACHEMAX	(4*1024*1024)		/* max bytes cached	*/
+#define GLOB_CACHEAGE	((Time_t)1000000000)	/* min age in ns	*/
+
+#define GLOB_TUNKNOWN	1			/* entry type unknown	*/
+#define GLOB_TDIR	2			/* entry is a directory	*/
+#define GLOB_TNOTDIR	3			/* entry not a directory	*/
+
+typedef struct Globdir_s
+{
+	struct Globdir_s*	next;
+	dev_t			dev;
+	ino_t			ino;
+	Time_t			mtime;
+	Time_t			ctime;
+	size_t			size;
+	int			err;		/* readdir() errno	*/
+	int			stat;		/* dev..ctime are set	*/
+	char			names[1];	/* type,name,0,...,0	*/
+} Globdir_t;
+
+typedef struct Globscan_s
+{
+	Globdir_t*		dir;
+	char*			next;
+	int			keep;		/* dir is in the cache	*/
+} Globscan_t;
+
+static struct
+{
+	Globdir_t*		hash[GLOB_CACHEDIRS];
+	size_t			size;
+} globcache;
+
+#if _lib_pthread_create && _hdr_pthread
+
+#include <pthread.h>
+#include <signal.h>
+
+/*
+ * GLOB_STARSTAR directory read-ahead
+ * once a ** component starts a traversal, a pool of up to GLOB_THREADS
+ * threads reads the directories below it ahead of glob_dir(), which
+ * still takes them one at a time in its usual order through gl_scanopen(),
+ * so the matches are the same as for a serial traversal; the threads
+ * are only started if reading a directory takes long enough on average
+ * to be worth overlapping, as on network file systems or cold disks
+ */
+
+#define GLOB_POOL	1
+#define GLOB_SCAN	(GLOB_CACHE|GLOB_STARSTAR)
+#define GLOB_THREADS	8			/* max read-ahead threads	*/
+#define GLOB_POOLHASH	1024			/* job hash table slots		*/
+#define GLOB_POOLMAX	(64*1024*1024)		/* max bytes read ahead		*/
+#define GLOB_POOLSLOW	((Time_t)100000)	/* slow directory read in ns	*/
+
+#define JOB_QUEUED	0			/* waiting for a thread		*/
+#define JOB_BUSY	1			/* being read by a thread	*/
+#define JOB_DONE	2			/* read by a thread		*/
+#define JOB_TAKEN	3			/* passed on to glob_dir()	*/
+
+typedef struct Globjob_s
+{
+	struct Globjob_s*	next;		/* hash chain			*/
+	struct Globjob_s*	stack;		/* job stack			*/
+	Globdir_t*		dir;
+	char*			prefix;		/* path prefix of entries	*/
+	unsigned int		hash;
+	int			state;
+	int			err;
+	char			path[1];
+} Globjob_t;
+
+typedef struct Globpool_s
+{
+	pthread_mutex_t		lock;
+	pthread_cond_t		work;		/* job queued or space freed	*/
+	pthread_cond_t		done;		/* job read			*/
+	pthread_t		thread[GLOB_THREADS];
+	glob_t*			gp;
+	Globjob_t*		hash[GLOB_POOLHASH];
+	Globjob_t*		stack;
+	size_t			size;		/* bytes read ahead		*/
+	Time_t			time;		/* glob_dir() read time		*/
+	int			reads;		/* glob_dir() reads		*/
+	int			queued;
+	int			threads;
+	int			stop;
+} Globpool_t;
+
+#define POOLLOCK(gp)	do { if ((gp)->gl_pool) pthread_mutex_lock(&((Globpool_t*)(gp)->gl_pool)->lock); } while (0)
+#define POOLUNLOCK(gp)	do { if ((gp)->gl_pool) pthread_mutex_unlock(&((Globpool_t*)(gp)->gl_pool)->lock); } while (0)
+
+#else
+
+#define GLOB_SCAN	GLOB_CACHE
+#define POOLLOCK(gp)
+#define POOLUNLOCK(gp)
+
+#endif
+
 /*
  * default gl_diropen
  */
@@ -94,10 +206,13 @@ gl_dirnext(glob_t* gp, void* handle)
 {
 	struct dirent*	dp;
 
+	gp->gl_status &= ~(GLOB_NOTDIR|GLOB_ISDIR);
 	while (dp = (struct dirent*)(*gp->gl_readdir)(handle))
 	{
 #ifdef D_TYPE
-		if (D_TYPE(dp) != DT_UNKNOWN && D_TYPE(dp) != DT_DIR && D_TYPE(dp) != DT_LNK)
+		if (D_TYPE(dp) == DT_DIR)
+			gp->gl_status |= GLOB_ISDIR;
+		else if (D_TYPE(dp) != DT_UNKNOWN && D_TYPE(dp) != DT_LNK)
 			gp->gl_status |= GLOB_NOTDIR;
 #endif
 		return dp->d_name;
@@ -115,6 +230,546 @@ gl_dirclose(glob_t* gp, void* handle)
 	(gp->gl_closedir)(handle);
 }
 
+/*
+ * read the entry names and types of directory path into a new Globdir_t
+ * st, if not 0, is the stat of path done just before
+ * may be called by read-ahead threads
+ */
+
+static Globdir_t*
+dirread(glob_t* gp, const char* path, struct stat* st)
+{
+	Globdir_t*	dp;
+	Globdir_t*	np;
+	void*		dirf;
+	struct dirent*	ep;
+	size_t		n;
+	size_t		m;
+	size_t		z;
+	int		i;
+
+	if (!(dirf = (*gp->gl_opendir)(path)))
+		return NULL;
+	z = 1024;
+	n = 0;
+	if (!(dp = newof(0, Globdir_t, 1, z)))
+		goto nospace;
+	errno = 0;
+	while (ep = (struct dirent*)(*gp->gl_readdir)(dirf))
+	{
+		if ((m = strlen(ep->d_name) + 2) + n >= z)
+		{
+			z = roundof(z + m, 1024) * 2;
+			if (!(np = oldof(dp, Globdir_t, 1, z)))
+			{
+				free(dp);
+				goto nospace;
+			}
+			dp = np;
+		}
+		i = GLOB_TUNKNOWN;
+#ifdef D_TYPE
+		if (D_TYPE(ep) == DT_DIR)
+			i = GLOB_TDIR;
+		else if (D_TYPE(ep) != DT_UNKNOWN && D_TYPE(ep) != DT_LNK)
+			i = GLOB_TNOTDIR;
+#endif
+		dp->names[n] = i;
+		memcpy(dp->names + n + 1, ep->d_name, m - 1);
+		n += m;
+		errno = 0;
+	}
+	dp->err = errno;
+	(*gp->gl_closedir)(dirf);
+	dp->names[n] = 0;
+	dp->size = sizeof(Globdir_t) + n;
+	if (st)
+	{
+		dp->dev = st->st_dev;
+		dp->ino = st->st_ino;
+		dp->mtime = tmxgetmtime(st);
+		dp->ctime = tmxgetctime(st);
+		dp->stat = 1;
+	}
+	return dp;
+ nospace:
+	(*gp->gl_closedir)(dirf);
+	errno = ENOMEM;
+	return NULL;
+}
+
+/*
+ * return the cached entry list of the directory with stat st
+ * stale entries are dropped unless keep!=0
+ */
+
+static Globdir_t*
+cachelook(struct stat* st, int keep)
+{
+	Globdir_t*	dp;
+	Globdir_t**	hp;
+
+	hp = &globcache.hash[(unsigned long)(st->st_ino ^ st->st_dev) % GLOB_CACHEDIRS];
+	for (; dp = *hp; hp = &dp->next)
+		if (dp->ino == st->st_ino && dp->dev == st->st_dev)
+		{
+			if (dp->mtime == tmxgetmtime(st) && dp->ctime == tmxgetctime(st))
+				return dp;
+			if (!keep)
+			{
+				*hp = dp->next;
+				globcache.size -= dp->size;
+				free(dp);
+			}
+			break;
+		}
+	return NULL;
+}
+
+/*
+ * add dp to the cache if eligible
+ * return 1 if added, 0 if dp is still owned by the caller
+ */
+
+static int
+cacheadd(Globdir_t* dp)
+{
+	Globdir_t*	op;
+	Globdir_t**	hp;
+	Time_t		now;
+	int		i;
+
+	now = tmxgettime();
+	if (!dp->stat || dp->err || dp->size > GLOB_CACHEMAX / 4 || now - dp->mtime < GLOB_CACHEAGE || now - dp->ctime < GLOB_CACHEAGE)
+		return 0;
+	if (globcache.size + dp->size > GLOB_CACHEMAX)
+	{
+		/* flush the whole cache rather than keep track of use */
+		for (i = 0; i < GLOB_CACHEDIRS; i++)
+			while (hp = &globcache.hash[i], op = *hp)
+			{
+				*hp = op->next;
+				free(op);
+			}
+		globcache.size = 0;
+	}
+	hp = &globcache.hash[(unsigned long)(dp->ino ^ dp->dev) % GLOB_CACHEDIRS];
+	for (; op = *hp; hp = &op->next)
+		if (op->ino == dp->ino && op->dev == dp->dev)
+		{
+			*hp = op->next;
+			globcache.size -= op->size;
+			free(op);
+			break;
+		}
+	hp = &globcache.hash[(unsigned long)(dp->ino ^ dp->dev) % GLOB_CACHEDIRS];
+	dp->next = *hp;
+	*hp = dp;
+	globcache.size += dp->size;
+	return 1;
+}
+
+#if GLOB_POOL
+
+/*
+ * add a job for directory dir/name, or name if dir==0, to the pool unless
+ * it is already there; the entries of a root job are prefixed by prefix,
+ * those of others by the directory path itself
+ * pool must be locked
+ */
+
+static void
+pooljob(Globpool_t* pp, const char* dir, const char* name, int root, const char* prefix)
+{
+	Globjob_t*	jp;
+	Globjob_t*	op;
+	Globjob_t**	hp;
+	size_t		n;
+	size_t		k;
+	size_t		m;
+
+	n = dir ? strlen(dir) + 1 : 0;
+	k = strlen(name);
+	m = root && prefix ? strlen(prefix) + 1 : 0;
+	if (!(jp = newof(0, Globjob_t, 1, n + k + m)))
+		return;
+	if (n)
+	{
+		memcpy(jp->path, dir, n - 1);
+		jp->path[n - 1] = pp->gp->gl_delim;
+	}
+	memcpy(jp->path + n, name, k + 1);
+	if (!root)
+		jp->prefix = jp->path;
+	else if (m)
+		jp->prefix = strcpy(jp->path + n + k + 1, prefix);
+	jp->hash = strhash(jp->path);
+	for (hp = &pp->hash[jp->hash % GLOB_POOLHASH]; op = *hp; hp = &op->next)
+		if (op->hash == jp->hash && streq(op->path, jp->path))
+		{
+			free(jp);
+			return;
+		}
+	*hp = jp;
+	jp->stack = pp->stack;
+	pp->stack = jp;
+	pp->queued++;
+}
+
+/*
+ * read the directory for job jp without the pool lock
+ * unknown entry types are looked up so that the
+ * subdirectories can be queued by poolpush()
+ */
+
+static Globdir_t*
+poolscan(Globpool_t* pp, Globjob_t* jp)
+{
+	glob_t*		gp = pp->gp;
+	Globdir_t*	dp;
+	Globdir_t*	cp;
+	char*		s;
+	char*		t;
+	size_t		n;
+	struct stat	st;
+
+	if (gp->gl_flags & GLOB_CACHE)
+	{
+		if ((*gp->gl_stat)(jp->path, &st))
+			return NULL;
+		pthread_mutex_lock(&pp->lock);
+		if ((cp = cachelook(&st, 1)) && (dp = newof(0, Globdir_t, 1, cp->size - sizeof(Globdir_t))))
+		{
+			memcpy(dp, cp, cp->size);
+			dp->stat = 0;
+		}
+		else
+			dp = 0;
+		pthread_mutex_unlock(&pp->lock);
+		if (!dp && !(dp = dirread(gp, jp->path, &st)))
+			return NULL;
+	}
+	else if (!(dp = dirread(gp, jp->path, NULL)))
+		return NULL;
+	for (s = dp->names; *s; s += strlen(s) + 1)
+		if (*s++ == GLOB_TUNKNOWN && (s[0] != '.' || s[1] && (s[1] != '.' || s[2])))
+		{
+			n = jp->prefix ? strlen(jp->prefix) + 1 : 0;
+			if (t = newof(0, char, n + strlen(s) + 1, 0))
+			{
+				if (n)
+				{
+					strcpy(t, jp->prefix);
+					t[n - 1] = gp->gl_delim;
+				}
+				strcpy(t + n, s);
+				if (!(*gp->gl_lstat)(t, &st))
+					s[-1] = S_ISDIR(st.st_mode) ? GLOB_TDIR : S_ISLNK(st.st_mode) ? GLOB_TUNKNOWN : GLOB_TNOTDIR;
+				free(t);
+			}
+		}
+	return dp;
+}
+
+/*
+ * queue the subdirectories of the job jp directory dp
+ * pool must be locked
+ */
+
+static void
+poolpush(Globpool_t* pp, Globjob_t* jp, Globdir_t* dp)
+{
+	char*		s;
+	int		queued = pp->queued;
+
+	if (!dp)
+		return;
+	for (s = dp->names; *s; s += strlen(s) + 1)
+		if (*s++ == GLOB_TDIR && (s[0] != '.' || s[1] && (s[1] != '.' || s[2])))
+			pooljob(pp, jp->prefix, s, 0, NULL);
+	if (pp->queued > queued)
+		pthread_cond_broadcast(&pp->work);
+}
+
+/*
+ * read-ahead thread
+ */
+
+static void*
+poolwork(void* arg)
+{
+	Globpool_t*	pp = (Globpool_t*)arg;
+	Globjob_t*	jp;
+	Globdir_t*	dp;
+	int		err;
+
+	pthread_mutex_lock(&pp->lock);
+	for (;;)
+	{
+		while (!pp->stop && (!pp->stack || pp->size > GLOB_POOLMAX))
+			pthread_cond_wait(&pp->work, &pp->lock);
+		if (pp->stop)
+			break;
+		jp = pp->stack;
+		pp->stack = jp->stack;
+		if (jp->state != JOB_QUEUED)
+			continue;
+		pp->queued--;
+		jp->state = JOB_BUSY;
+		pthread_mutex_unlock(&pp->lock);
+		dp = poolscan(pp, jp);
+		err = errno;
+		pthread_mutex_lock(&pp->lock);
+		poolpush(pp, jp, dp);
+		jp->dir = dp;
+		jp->err = err;
+		jp->state = JOB_DONE;
+		if (dp)
+			pp->size += dp->size;
+		pthread_cond_broadcast(&pp->done);
+	}
+	pthread_mutex_unlock(&pp->lock);
+	return NULL;
+}
+
+/*
+ * start read-ahead threads while there is enough queued work
+ * pool must be locked
+ */
+
+static void
+poolspawn(Globpool_t* pp)
+{
+	sigset_t	all;
+	sigset_t	old;
+
+	if (pp->threads >= GLOB_THREADS || pp->queued <= 4 * (pp->threads + 1))
+		return;
+	if (!pp->threads && (pp->reads < 4 || pp->time / pp->reads < GLOB_POOLSLOW))
+		return;
+	/* the shell's signal handlers must run in the main thread */
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, &old);
+	while (pp->threads < GLOB_THREADS && pp->queued > 4 * (pp->threads + 1))
+		if (pthread_create(&pp->thread[pp->threads], NULL, poolwork, pp))
+			break;
+		else
+			pp->threads++;
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
+
+/*
+ * start a read-ahead traversal of dirname for glob_dir()
+ */
+
+static void
+poolroot(glob_t* gp, const char* prefix, const char* dirname)
+{
+	Globpool_t*	pp;
+
+	if (!(pp = (Globpool_t*)gp->gl_pool))
+	{
+		if (!(pp = newof(0, Globpool_t, 1, 0)))
+			return;
+		if (pthread_mutex_init(&pp->lock, NULL))
+		{
+			free(pp);
+			return;
+		}
+		pthread_cond_init(&pp->work, NULL);
+		pthread_cond_init(&pp->done, NULL);
+		pp->gp = gp;
+		gp->gl_pool = pp;
+	}
+	pthread_mutex_lock(&pp->lock);
+	pooljob(pp, NULL, dirname, 1, prefix);
+	pthread_mutex_unlock(&pp->lock);
+}
+
+/*
+ * get the directory path from the pool, reading it now if no thread has
+ * started on it yet, and waiting for it otherwise
+ * return 0 if path is not in the pool
+ */
+
+static int
+pooltake(Globpool_t* pp, const char* path, Globdir_t** dpp)
+{
+	Globjob_t*	jp;
+	Globdir_t*	dp;
+	Time_t		t;
+	unsigned int	h;
+	int		err;
+
+	h = strhash(path);
+	pthread_mutex_lock(&pp->lock);
+	for (jp = pp->hash[h % GLOB_POOLHASH]; jp; jp = jp->next)
+		if (jp->hash == h && streq(jp->path, path))
+			break;
+	if (!jp || jp->state == JOB_TAKEN)
+	{
+		pthread_mutex_unlock(&pp->lock);
+		return 0;
+	}
+	if (jp->state == JOB_QUEUED)
+	{
+		pp->queued--;
+		jp->state = JOB_TAKEN;
+		pthread_mutex_unlock(&pp->lock);
+		t = tmxgettime();
+		dp = poolscan(pp, jp);
+		err = errno;
+		t = tmxgettime() - t;
+		pthread_mutex_lock(&pp->lock);
+		pp->time += t;
+		pp->reads++;
+		poolpush(pp, jp, dp);
+	}
+	else
+	{
+		while (jp->state == JOB_BUSY)
+			pthread_cond_wait(&pp->done, &pp->lock);
+		if (dp = jp->dir)
+		{
+			pp->size -= dp->size;
+			pthread_cond_signal(&pp->work);
+		}
+		err = jp->err;
+		jp->dir = 0;
+		jp->state = JOB_TAKEN;
+	}
+	poolspawn(pp);
+	pthread_mutex_unlock(&pp->lock);
+	if (!(*dpp = dp))
+		errno = err;
+	return 1;
+}
+
+/*
+ * stop the read-ahead threads and free the pool
+ */
+
+static void
+poolfree(glob_t* gp)
+{
+	Globpool_t*	pp = (Globpool_t*)gp->gl_pool;
+	Globjob_t*	jp;
+	int		i;
+
+	pthread_mutex_lock(&pp->lock);
+	pp->stop = 1;
+	pthread_cond_broadcast(&pp->work);
+	pthread_mutex_unlock(&pp->lock);
+	for (i = 0; i < pp->threads; i++)
+		pthread_join(pp->thread[i], NULL);
+	for (i = 0; i < GLOB_POOLHASH; i++)
+		while (jp = pp->hash[i])
+		{
+			pp->hash[i] = jp->next;
+			if (jp->dir)
+				free(jp->dir);
+			free(jp);
+		}
+	pthread_cond_destroy(&pp->work);
+	pthread_cond_destroy(&pp->done);
+	pthread_mutex_destroy(&pp->lock);
+	free(pp);
+	gp->gl_pool = 0;
+}
+
+#endif
+
+/*
+ * GLOB_CACHE and GLOB_STARSTAR gl_diropen
+ */
+
+static void*
+gl_scanopen(glob_t* gp, const char* path)
+{
+	Globscan_t*	sp;
+	Globdir_t*	dp;
+	struct stat	st;
+	int		keep = 0;
+
+#if GLOB_POOL
+	if (!gp->gl_pool || !pooltake((Globpool_t*)gp->gl_pool, path, &dp))
+#endif
+	{
+		if (gp->gl_flags & GLOB_CACHE)
+		{
+			if ((*gp->gl_stat)(path, &st))
+				return NULL;
+			POOLLOCK(gp);
+			if (dp = cachelook(&st, 0))
+				keep = 1;
+			POOLUNLOCK(gp);
+			if (!dp)
+				dp = dirread(gp, path, &st);
+		}
+		else
+			dp = dirread(gp, path, NULL);
+	}
+	if (!dp)
+		return NULL;
+	if (!keep && (gp->gl_flags & GLOB_CACHE))
+	{
+		POOLLOCK(gp);
+		keep = cacheadd(dp);
+		POOLUNLOCK(gp);
+	}
+	if (!(sp = newof(0, Globscan_t, 1, 0)))
+	{
+		if (!keep)
+			free(dp);
+		return NULL;
+	}
+	sp->dir = dp;
+	sp->next = dp->names;
+	sp->keep = keep;
+	return sp;
+}
+
+/*
+ * GLOB_CACHE and GLOB_STARSTAR gl_dirnext
+ */
+
+static char*
+gl_scannext(glob_t* gp, void* handle)
+{
+	Globscan_t*	sp = (Globscan_t*)handle;
+	char*		s;
+
+	gp->gl_status &= ~(GLOB_NOTDIR|GLOB_ISDIR);
+	if (!*(s = sp->next))
+	{
+		if (sp->dir->err)
+			errno = sp->dir->err;
+		return NULL;
+	}
+	if (*s == GLOB_TDIR)
+		gp->gl_status |= GLOB_ISDIR;
+	else if (*s == GLOB_TNOTDIR)
+		gp->gl_status |= GLOB_NOTDIR;
+	s++;
+	sp->next = s + strlen(s) + 1;
+	return s;
+}
+
+/*
+ * GLOB_CACHE and GLOB_STARSTAR gl_dirclose
+ */
+
+static void
+gl_scanclose(glob_t* gp, void* handle)
+{
+	Globscan_t*	sp = (Globscan_t*)handle;
+
+	NOT_USED(gp);
+	if (!sp->keep)
+		free(sp->dir);
+	free(sp);
+}
+
 /*
  * default gl_type
  */
@@ -232,8 +887,12 @@ trim(char* sp, char* p1, int* n1, char* p2, int* n2)
 	} while (*dp++ = c);
 }
 
+/*
+ * isdir>0 if pat is known to be a directory (not a symlink), <0 if known not to be one
+ */
+
 static void
-addmatch(glob_t* gp, const char* dir, const char* pat, const char* rescan, char* endslash, int meta)
+addmatch(glob_t* gp, const char* dir, const char* pat, const char* rescan, char* endslash, int meta, int isdir)
 {
 	globlist_t*	ap;
 	int		offset;
@@ -250,7 +909,7 @@ addmatch(glob_t* gp, const char* dir, const char* pat, const char* rescan, char*
 	sfputr(globstk,pat,-1);
 	if (rescan)
 	{
-		if ((*gp->gl_type)(gp, stkptr(globstk,MATCHPATH(gp)), 0) != GLOB_DIR)
+		if (isdir < 0 || !isdir && (*gp->gl_type)(gp, stkptr(globstk,MATCHPATH(gp)), 0) != GLOB_DIR)
 			return;
 		sfputc(globstk,gp->gl_delim);
 		offset = stktell(globstk);
@@ -265,10 +924,16 @@ addmatch(glob_t* gp, const char* dir, const char* pat, const char* rescan, char*
 		ap->gl_begin = (char*)rescan;
 		ap->gl_next = gp->gl_rescan;
 		gp->gl_rescan = ap;
+		if (isdir > 0)
+			meta |= MATCH_DIR;
 	}
 	else
 	{
-		if (!endslash && (gp->gl_flags & GLOB_MARK) && (type = (*gp->gl_type)(gp, stkptr(globstk,MATCHPATH(gp)), 0)))
+		if (isdir && !(gp->gl_flags & GLOB_COMPLETE))
+			type = isdir > 0 ? GLOB_DIR : GLOB_REG;
+		else
+			type = 0;
+		if (!endslash && (gp->gl_flags & GLOB_MARK) && (type || (type = (*gp->gl_type)(gp, stkptr(globstk,MATCHPATH(gp)), 0))))
 		{
 			if ((gp->gl_flags & GLOB_COMPLETE) && type != GLOB_EXE)
 			{
@@ -310,6 +975,7 @@ glob_dir(glob_t* gp, globlist_t* ap, int re_flags)
 	regex_t		rec;
 	regex_t		rei;
 	int		notdir;
+	int		isdir;
 	int		t1;
 	int		t2;
 	int		bracket;
@@ -326,6 +992,8 @@ glob_dir(glob_t* gp, globlist_t* ap, int re_flags)
 	regex_t*	prei = 0;
 	char*		matchdir = 0;
 	int		starstar = 0;
+	int		dtype = gp->gl_type == gl_type;
+	int		knowndir = 0;
 
 	if (*gp->gl_intr)
 	{
@@ -355,13 +1023,16 @@ again:
 			if (!first && !*rescan && *(rescan - 2) == gp->gl_delim)
 			{
 				*(rescan - 2) = 0;
-				c = (*gp->gl_type)(gp, prefix, 0);
+				if ((ap->gl_flags & MATCH_DIR) && rescan - 1 == ap->gl_begin)
+					c = GLOB_DIR;
+				else
+					c = (*gp->gl_type)(gp, prefix, 0);
 				*(rescan - 2) = gp->gl_delim;
 				if (c == GLOB_DIR)
-					addmatch(gp, NULL, prefix, NULL, rescan - 1, anymeta);
+					addmatch(gp, NULL, prefix, NULL, rescan - 1, anymeta, 1);
 			}
 			else if ((anymeta || !(gp->gl_flags & GLOB_NOCHECK)) && (*gp->gl_type)(gp, prefix, 0))
-				addmatch(gp, NULL, prefix, NULL, NULL, anymeta);
+				addmatch(gp, NULL, prefix, NULL, NULL, anymeta, 0);
 			return;
 		case '[':
 			if (!bracket)
@@ -478,8 +1149,15 @@ skip:
 	}
 	if (matchdir)
 		gp->gl_starstar++;
+	/* a rescan directory found with d_type need not be checked again */
+	if ((ap->gl_flags & MATCH_DIR) && restore1 == ap->gl_begin - 1)
+		knowndir = 1;
 	if (gp->gl_opt)
 		pat = strcpy(gp->gl_opt, pat);
+#if GLOB_POOL
+	if (matchdir && !complete && gp->gl_diropen == gl_scanopen)
+		poolroot(gp, prefix, dirname);
+#endif
 	for (;;)
 	{
 		if (complete)
@@ -488,7 +1166,7 @@ skip:
 				break;
 			prefix = streq(dirname, ".") ? NULL : dirname;
 		}
-		if ((!starstar && !gp->gl_starstar || (t1 = (*gp->gl_type)(gp, dirname, GLOB_STARSTAR)) == GLOB_DIR
+		if ((!starstar && !gp->gl_starstar || (t1 = knowndir && !complete ? GLOB_DIR : (*gp->gl_type)(gp, dirname, GLOB_STARSTAR)) == GLOB_DIR
 			|| t1 == GLOB_SYM && pat[0]=='*' && pat[1]=='\0') /* follow symlinks to dirs for non-globstar components */
 		&& (dirf = (*gp->gl_diropen)(gp, dirname)))
 		{
@@ -555,16 +1233,19 @@ skip:
 					continue;
 				if (notdir = (gp->gl_status & GLOB_NOTDIR))
 					gp->gl_status &= ~GLOB_NOTDIR;
+				if (isdir = (gp->gl_status & GLOB_ISDIR))
+					gp->gl_status &= ~GLOB_ISDIR;
 				if (ire && !regexec(ire, name, 0, NULL, 0))
 					continue;
+				isdir = !dtype ? 0 : isdir ? 1 : notdir ? -1 : 0;
 				if (matchdir && (name[0] != '.' || name[1] && (name[1] != '.' || name[2])) && !notdir)
-					addmatch(gp, prefix, name, matchdir, NULL, anymeta);
+					addmatch(gp, prefix, name, matchdir, NULL, anymeta, isdir);
 				if (!regexec(pre, name, 0, NULL, 0))
 				{
 					if (!rescan || !notdir)
-						addmatch(gp, prefix, name, rescan, NULL, anymeta);
+						addmatch(gp, prefix, name, rescan, NULL, anymeta, isdir);
 					if (starstar==1 || (starstar==2 && !notdir))
-						addmatch(gp, prefix, name, starstar==2?"":NULL, NULL, anymeta);
+						addmatch(gp, prefix, name, starstar==2?"":NULL, NULL, anymeta, isdir);
 				}
 				errno = 0;
 			}
@@ -616,6 +1297,7 @@ _ast_glob(const char* pattern, int flags, int (*errfn)(const char*, int), glob_t
 	unsigned char	intr = 0;
 
 	gp->gl_rescan = 0;
+	gp->gl_pool = 0;
 	gp->gl_error = 0;
 	gp->gl_errfn = errfn;
 	if (flags & GLOB_APPEND)
@@ -668,6 +1350,12 @@ _ast_glob(const char* pattern, int flags, int (*errfn)(const char*, int), glob_t
 			gp->gl_intr = &intr;
 		if (!gp->gl_delim)
 			gp->gl_delim = '/';
+		if ((flags & GLOB_SCAN) && !(flags & GLOB_ALTDIRFUNC) && !gp->gl_diropen && !gp->gl_dirnext && !gp->gl_dirclose)
+		{
+			gp->gl_diropen = gl_scanopen;
+			gp->gl_dirnext = gl_scannext;
+			gp->gl_dirclose = gl_scanclose;
+		}
 		if (!gp->gl_diropen)
 			gp->gl_diropen = gl_diropen;
 		if (!gp->gl_dirnext)
@@ -784,6 +1472,10 @@ _ast_glob(const char* pattern, int flags, int (*errfn)(const char*, int), glob_t
 		gp->gl_rescan = ap->gl_next;
 		glob_dir(gp, ap, re_flags);
 	} while (!gp->gl_error && (ap = gp->gl_rescan));
+#if GLOB_POOL
+	if (gp->gl_pool)
+		poolfree(gp);
+#endif
 	gp->re_flags = re_flags;
 	if (gp->gl_pathc == skip)
 	{
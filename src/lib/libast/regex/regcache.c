@@ -21,36 +21,96 @@
 /*
  * regcomp() regex_t cache
  * AT&T Research
+ *
+ * cached re's are found through a hash table and kept on a list in least
+ * recently used order; the cache starts small and grows up to the limit
+ * set by regcache(0,n,...) while the least recently used entry is still
+ * part of the working set when it is about to be discarded
  */
 
 #include <ast.h>
 #include <regex.h>
 
-#define CACHE		8		/* default # cached re's	*/
+#define CACHE		16		/* initial # cached re's	*/
+#define CACHE_MAX	256		/* default max # cached re's	*/
 #define ROUND		64		/* pattern buffer size round	*/
 
-typedef unsigned long Key_t;
-
 typedef struct Cache_s
 {
+	struct Cache_s*	next;		/* hash chain			*/
+	struct Cache_s*	older;		/* LRU list			*/
+	struct Cache_s*	newer;
 	char*		pattern;
 	regex_t		re;
 	unsigned long	serial;
+	unsigned int	hash;
 	regflags_t	reflags;
-	int		keep;
 	int		size;
 } Cache_t;
 
 typedef struct State_s
 {
-	unsigned int	size;
+	unsigned int	size;		/* current # of entries allowed	*/
+	unsigned int	max;		/* max # of entries		*/
+	unsigned int	count;		/* # of entries			*/
+	unsigned int	mask;		/* hash table size - 1		*/
 	unsigned long	serial;
 	char*		locale;
-	Cache_t**	cache;
+	Cache_t**	table;
+	Cache_t*	newest;
+	Cache_t*	oldest;
+	regcachestat_t	stat;
 } State_t;
 
 static State_t	matchstate;
 
+/*
+ * make cp the most recently used entry
+ */
+
+static void
+newest(Cache_t* cp)
+{
+	cp->newer = 0;
+	if (cp->older = matchstate.newest)
+		cp->older->newer = cp;
+	else
+		matchstate.oldest = cp;
+	matchstate.newest = cp;
+}
+
+/*
+ * unlink cp from the LRU list
+ */
+
+static void
+unlist(Cache_t* cp)
+{
+	if (cp->newer)
+		cp->newer->older = cp->older;
+	else
+		matchstate.newest = cp->older;
+	if (cp->older)
+		cp->older->newer = cp->newer;
+	else
+		matchstate.oldest = cp->newer;
+}
+
+/*
+ * unlink cp from the hash table and the LRU list
+ */
+
+static void
+unlinkcache(Cache_t* cp)
+{
+	Cache_t**	pp;
+
+	for (pp = &matchstate.table[cp->hash & matchstate.mask]; *pp != cp; pp = &(*pp)->next);
+	*pp = cp->next;
+	unlist(cp);
+	matchstate.count--;
+}
+
 /*
  * flush the cache
  */
@@ -58,14 +118,42 @@ static State_t	matchstate;
 static void
 flushcache(void)
 {
-	int		i;
+	Cache_t*	cp;
 
-	for (i = matchstate.size; i--;)
-		if (matchstate.cache[i] && matchstate.cache[i]->keep)
-		{
-			matchstate.cache[i]->keep = 0;
-			regfree(&matchstate.cache[i]->re);
-		}
+	while (cp = matchstate.oldest)
+	{
+		unlinkcache(cp);
+		regfree(&cp->re);
+		free(cp->pattern);
+		free(cp);
+	}
+}
+
+/*
+ * size the hash table for n entries
+ */
+
+static int
+sizecache(unsigned int n)
+{
+	Cache_t**	table;
+	Cache_t*	cp;
+	unsigned int	m;
+
+	for (m = 2 * CACHE; m < 2 * n; m <<= 1);
+	if (m - 1 <= matchstate.mask)
+		return 0;
+	if (!(table = newof(0, Cache_t*, m, 0)))
+		return -1;
+	for (cp = matchstate.oldest; cp; cp = cp->newer)
+	{
+		cp->next = table[cp->hash & (m - 1)];
+		table[cp->hash & (m - 1)] = cp;
+	}
+	free(matchstate.table);
+	matchstate.table = table;
+	matchstate.mask = m - 1;
+	return 0;
 }
 
 /*
@@ -78,38 +166,42 @@ regcache(const char* pattern, regflags_t reflags, int* status)
 	Cache_t*	cp;
 	int		i;
 	char*		s;
-	int		empty;
-	int		unused;
-	int		old;
-	Key_t		key;
+	unsigned int	h;
 
 	/*
-	 * 0 pattern flushes the cache and reflags>0 extends cache
+	 * 0 pattern flushes the cache and reflags>0 sets the size limit
 	 */
 
 	if (!pattern)
 	{
 		flushcache();
 		i = 0;
-		if (reflags > matchstate.size)
+		if (reflags > 0)
 		{
-			if (matchstate.cache = newof(matchstate.cache, Cache_t*, reflags, 0))
-				matchstate.size = reflags;
-			else
+			matchstate.max = reflags;
+			if (!matchstate.size)
+				matchstate.size = matchstate.max < CACHE ? matchstate.max : CACHE;
+			else if (matchstate.size > matchstate.max)
+				matchstate.size = matchstate.max;
+			if (sizecache(matchstate.size))
 			{
-				matchstate.size = 0;
+				matchstate.size = matchstate.max = 0;
 				i = 1;
 			}
+			matchstate.stat.size = matchstate.size;
 		}
 		if (status)
 			*status = i;
 		return NULL;
 	}
-	if (!matchstate.cache)
+	if (!matchstate.table)
 	{
-		if (!(matchstate.cache = newof(0, Cache_t*, CACHE, 0)))
+		if (!matchstate.max)
+			matchstate.max = CACHE_MAX;
+		if (!matchstate.size)
+			matchstate.size = CACHE;
+		if (sizecache(matchstate.size))
 			return NULL;
-		matchstate.size = CACHE;
 	}
 
 	/*
@@ -128,68 +220,100 @@ regcache(const char* pattern, regflags_t reflags, int* status)
 	 * check if the pattern is in the cache
 	 */
 
-	for (i = 0; i < sizeof(key) && pattern[i]; i++)
-		((char*)&key)[i] = pattern[i];
-	for (; i < sizeof(key); i++)
-		((char*)&key)[i] = 0;
-	empty = unused = -1;
-	old = 0;
-	for (i = matchstate.size; i--;)
-		if (!matchstate.cache[i])
-			empty = i;
-		else if (!matchstate.cache[i]->keep)
-			unused = i;
-		else if (*(Key_t*)matchstate.cache[i]->pattern == key && !strcmp(matchstate.cache[i]->pattern, pattern) && matchstate.cache[i]->reflags == reflags)
+	h = 2166136261U;
+	for (s = (char*)pattern; *s; s++)
+		h = (h ^ (unsigned char)*s) * 16777619U;
+	h ^= (unsigned int)reflags * 2654435761U;
+	for (cp = matchstate.table[h & matchstate.mask]; cp; cp = cp->next)
+		if (cp->hash == h && cp->reflags == reflags && !strcmp(cp->pattern, pattern))
 			break;
-		else if (!matchstate.cache[old] || matchstate.cache[old]->serial > matchstate.cache[i]->serial)
-			old = i;
-	if (i < 0)
+	if (cp)
+	{
+		matchstate.stat.hits++;
+		if (cp != matchstate.newest)
+		{
+			unlist(cp);
+			newest(cp);
+		}
+	}
+	else
 	{
-		if (unused < 0)
+		matchstate.stat.misses++;
+		if (matchstate.count >= matchstate.size)
 		{
-			if (empty < 0)
-				unused = old;
-			else
-				unused = empty;
+			/*
+			 * grow instead of discarding an entry that
+			 * is still in use by a cycle of patterns
+			 */
+
+			cp = matchstate.oldest;
+			if (matchstate.size < matchstate.max && matchstate.serial - cp->serial < 2 * matchstate.size)
+			{
+				i = matchstate.size * 2;
+				if (i > matchstate.max)
+					i = matchstate.max;
+				if (!sizecache(i))
+				{
+					matchstate.size = i;
+					cp = 0;
+				}
+			}
+			if (cp)
+			{
+				unlinkcache(cp);
+				regfree(&cp->re);
+				matchstate.stat.discards++;
+			}
 		}
-		if (!(cp = matchstate.cache[unused]) && !(cp = matchstate.cache[unused] = newof(0, Cache_t, 1, 0)))
+		else
+			cp = 0;
+		if (!cp && !(cp = newof(0, Cache_t, 1, 0)))
 		{
 			if (status)
 				*status = REG_ESPACE;
 			return NULL;
 		}
-		if (cp->keep)
-		{
-			cp->keep = 0;
-			regfree(&cp->re);
-		}
 		if ((i = strlen(pattern) + 1) > cp->size)
 		{
 			cp->size = roundof(i, ROUND);
 			if (!(cp->pattern = newof(cp->pattern, char, cp->size, 0)))
 			{
+				free(cp);
 				if (status)
 					*status = REG_ESPACE;
 				return NULL;
 			}
 		}
 		strcpy(cp->pattern, pattern);
-		while (++i < sizeof(Key_t))
-			cp->pattern[i] = 0;
-		pattern = (const char*)cp->pattern;
-		if (i = regcomp(&cp->re, pattern, reflags))
+		if (i = regcomp(&cp->re, cp->pattern, reflags))
 		{
+			free(cp->pattern);
+			free(cp);
 			if (status)
 				*status = i;
 			return NULL;
 		}
-		cp->keep = 1;
 		cp->reflags = reflags;
+		cp->hash = h;
+		cp->next = matchstate.table[h & matchstate.mask];
+		matchstate.table[h & matchstate.mask] = cp;
+		newest(cp);
+		matchstate.count++;
 	}
-	else
-		cp = matchstate.cache[i];
 	cp->serial = ++matchstate.serial;
+	matchstate.stat.size = matchstate.size;
 	if (status)
 		*status = 0;
 	return &cp->re;
 }
+
+/*
+ * return the regcache() statistics
+ */
+
+regcachestat_t*
+regcachestat(void)
+{
+	matchstate.stat.max = matchstate.max ? matchstate.max : CACHE_MAX;
+	return &matchstate.stat;
+}
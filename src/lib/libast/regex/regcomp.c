@@ -584,10 +584,11 @@ stats(Cenv_t* env, Rex_t* e)
 				m = env->stats.m;
 				if ((env->stats.m += cm) < m)
 					return 1;
+				/* a string or trie in the first repetition is that far into it */
 				if (env->stats.x != x)
-					env->stats.l = cm;
+					env->stats.l += cm;
 				if (env->stats.y != y)
-					env->stats.k = cm;
+					env->stats.k += cm;
 			}
 			break;
 		case REX_STRING:
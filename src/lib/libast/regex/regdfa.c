@@ -0,0 +1,770 @@
+/***********************************************************************
+*                                                                      *
+*              This file is part of the ksh 93u+m package              *
+*             Copyright (c) 2026 Contributors to ksh 93u+m             *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+*                  Martijn Dekker <martijn@inlv.org>                   *
+*                                                                      *
+***********************************************************************/
+
+/*
+ * POSIX regex executor
+ * lazy DFA for matches that only need a yes/no answer
+ *
+ * the compiled Rex_t list is translated into a Thompson NFA of at most
+ * DFA_NFA states; DFA states are sets of NFA states that are built on
+ * demand as the subject is scanned, and are cached in a table of at most
+ * DFA_STATES states that is flushed when full, so each subject byte is
+ * handled in constant time no matter how much the backtracking matcher
+ * in regnexec.c would have to backtrack
+ *
+ * expressions with back references, negation, conjunction, lookaround
+ * and the like are left to regnexec.c, as are subjects with non-ASCII
+ * bytes in multibyte locales; since the subject is then ASCII, collation
+ * classes become the set of ASCII bytes they match, unless the locale has
+ * multi-letter collating elements
+ *
+ * _AST_regex_dfa=0 in the environment disables the DFA, so that it can
+ * be compared with the backtracking matcher (see ksh tests/bench/regdfa.sh)
+ */
+
+#include "reglib.h"
+
+#define DFA_NFA		4096	/* max NFA states		*/
+#define DFA_STATES	1024	/* max cached DFA states	*/
+
+#define N_CHR		0	/* byte in set			*/
+#define N_SPLIT		1	/* epsilon to out and alt	*/
+#define N_BOL		2	/* ^				*/
+#define N_EOL		3	/* $				*/
+#define N_MATCH		4	/* the end			*/
+
+#define C_BEG		0x01	/* at beginning of subject	*/
+#define C_END		0x02	/* at end of subject		*/
+#define C_NL		0x04	/* after newline		*/
+#define C_NLNEXT	0x08	/* before newline		*/
+
+typedef struct Nfa_s
+{
+	unsigned char	type;
+	unsigned char	nl;		/* REG_NEWLINE anchor		*/
+	int		out;		/* next state			*/
+	int		alt;		/* N_SPLIT 2nd, N_CHR set index	*/
+} Nfa_t;
+
+typedef struct Dstate_s
+{
+	struct Dstate_s*	link;	/* hash chain			*/
+	int*			set;	/* sorted NFA states		*/
+	unsigned char*		skip;	/* bytes that leave this state	*/
+	unsigned int		hash;
+	int			ctx;	/* C_* context of the closure	*/
+	int			nset;	/* number of NFA states		*/
+	int			nskip;	/* number of skip bytes		*/
+	unsigned char		skipc;	/* the skip byte if nskip==1	*/
+	unsigned char		tried;	/* skip computed or not possible*/
+	unsigned char		stop;	/* match or dead end		*/
+	unsigned char		match;	/* match reached		*/
+	unsigned char		endmatch; /* match at end of subject	*/
+	unsigned char		nleol;	/* has REG_NEWLINE $		*/
+} Dstate_t;
+
+/* transitions by byte class follow the Dstate_t */
+#define NEXT(d)		((Dstate_t**)((d)+1))
+
+typedef struct Dfa_s
+{
+	Nfa_t*		nfa;		/* NFA states			*/
+	int		nnfa;
+	int		anfa;
+	Set_t*		sets;		/* N_CHR byte sets		*/
+	int		nsets;
+	int		asets;
+	int		start;		/* anchored start state		*/
+	int		loop;		/* unanchored start state	*/
+	int		nl;		/* has REG_NEWLINE anchors	*/
+	int		nclass;		/* number of byte classes	*/
+	int		multi;		/* multi-letter elements: 0 unknown 1 no 2 yes */
+	int		nlclass;	/* class of newline		*/
+	int		count;		/* cached DFA states		*/
+	int*		work;		/* closure scratch		*/
+	int*		list;		/* closure result		*/
+	unsigned int*	mark;		/* closure visit marks		*/
+	unsigned int	gen;		/* current mark			*/
+	Dstate_t*	begin[4];	/* [anchored][bol] start states	*/
+	Dstate_t	hit;		/* match before newline		*/
+	Dstate_t*	table[DFA_STATES];
+	unsigned char	class[UCHAR_MAX+1];
+	unsigned char	rep[UCHAR_MAX+1];
+} Dfa_t;
+
+/*
+ * add an NFA state, -1 if there are too many
+ */
+
+static int
+nfastate(Dfa_t* dfa, int type, int out, int alt)
+{
+	Nfa_t*	n;
+
+	if (dfa->nnfa >= dfa->anfa)
+	{
+		if (dfa->anfa >= DFA_NFA)
+			return -1;
+		dfa->anfa = dfa->anfa ? 2 * dfa->anfa : 64;
+		if (!(dfa->nfa = newof(dfa->nfa, Nfa_t, dfa->anfa, 0)))
+			return -1;
+	}
+	n = &dfa->nfa[dfa->nnfa];
+	n->type = type;
+	n->nl = 0;
+	n->out = out;
+	n->alt = alt;
+	return dfa->nnfa++;
+}
+
+/*
+ * add an empty byte set, 0 if there are too many
+ */
+
+static Set_t*
+nfaset(Dfa_t* dfa)
+{
+	if (dfa->nsets >= dfa->asets)
+	{
+		dfa->asets = dfa->asets ? 2 * dfa->asets : 16;
+		if (!(dfa->sets = newof(dfa->sets, Set_t, dfa->asets, 0)))
+			return NULL;
+	}
+	memset(&dfa->sets[dfa->nsets], 0, sizeof(Set_t));
+	return &dfa->sets[dfa->nsets++];
+}
+
+/*
+ * add an N_CHR state for the last set added by nfaset()
+ */
+
+static int
+nfachr(Dfa_t* dfa, int out)
+{
+	return nfastate(dfa, N_CHR, out, dfa->nsets - 1);
+}
+
+/*
+ * N_CHR state for byte c, folded by map
+ */
+
+static int
+nfabyte(Dfa_t* dfa, unsigned char* map, int c, int out)
+{
+	Set_t*	set;
+	int	i;
+
+	if (!(set = nfaset(dfa)))
+		return -1;
+	if (map)
+	{
+		for (i = 0; i <= UCHAR_MAX; i++)
+			if (map[i] == c)
+				setadd(set, i);
+	}
+	else
+		setadd(set, c);
+	return nfachr(dfa, out);
+}
+
+/*
+ * number of bytes that can be characters on their own in the subject,
+ * 0 if the locale may collate two of them as one element, as collmatch()
+ * would then match more than one byte
+ */
+
+static int
+nfamulti(Dfa_t* dfa)
+{
+	Ckey_t	key;
+	Ckey_t	elt;
+	size_t	r;
+	int	c;
+	int	d;
+	int	n;
+
+	n = mbwide() ? 0x80 : UCHAR_MAX + 1;
+	if (!dfa->multi)
+	{
+		dfa->multi = 1;
+		for (c = 0; c < n && dfa->multi == 1; c++)
+			if (isalpha(c))
+			{
+				key[0] = c;
+				key[1] = 0;
+				r = mbxfrm(elt, key, COLL_KEY_MAX);
+				for (d = 0; d < n; d++)
+					if (isalpha(d))
+					{
+						key[1] = d;
+						key[2] = 0;
+						if (mbxfrm(elt, key, COLL_KEY_MAX) == r)
+						{
+							dfa->multi = 2;
+							break;
+						}
+					}
+			}
+	}
+	return dfa->multi == 1 ? n : 0;
+}
+
+static int	nfa(Dfa_t*, Rex_t*, int);
+
+/*
+ * one iteration of rex
+ */
+
+static int
+nfaone(Dfa_t* dfa, Rex_t* rex, int out)
+{
+	Set_t*		set;
+	unsigned char*	e;
+	unsigned char	b;
+	int		c;
+	int		n;
+
+	switch (rex->type)
+	{
+	case REX_DOT:
+		if (!(set = nfaset(dfa)))
+			return -1;
+		memset(set, 0xff, sizeof(Set_t));
+		if (rex->explicit >= 0)
+			setclr(set, rex->explicit);
+		return nfachr(dfa, out);
+	case REX_CLASS:
+		if (!(set = nfaset(dfa)))
+			return -1;
+		*set = *rex->re.charclass;
+		return nfachr(dfa, out);
+	case REX_COLL_CLASS:
+		if (!(n = nfamulti(dfa)) || !(set = nfaset(dfa)))
+			return -1;
+		for (c = 0; c < n; c++)
+		{
+			b = c;
+			if (collmatch(rex, &b, &b + 1, &e))
+				setadd(set, c);
+		}
+		return nfachr(dfa, out);
+	case REX_ONECHAR:
+		return nfabyte(dfa, rex->map, rex->re.onechar, out);
+	case REX_REP:
+		return nfa(dfa, rex->re.group.expr.rex, out);
+	}
+	return -1;
+}
+
+/*
+ * rex{lo,hi} as lo copies of rex followed by either rex* or
+ * hi-lo nested optional copies
+ */
+
+static int
+nfarep(Dfa_t* dfa, Rex_t* rex, int out)
+{
+	int	i;
+	int	s;
+	int	t;
+
+	if (rex->lo > DFA_NFA || rex->hi != RE_DUP_INF && rex->hi - rex->lo > DFA_NFA)
+		return -1;
+	if (rex->hi == RE_DUP_INF)
+	{
+		if ((s = nfastate(dfa, N_SPLIT, -1, out)) < 0 || (t = nfaone(dfa, rex, s)) < 0)
+			return -1;
+		dfa->nfa[s].out = t;
+		out = s;
+	}
+	else
+		for (i = rex->lo; i < rex->hi; i++)
+			if ((t = nfaone(dfa, rex, out)) < 0 || (out = nfastate(dfa, N_SPLIT, t, out)) < 0)
+				return -1;
+	for (i = 0; i < rex->lo; i++)
+		if ((out = nfaone(dfa, rex, out)) < 0)
+			return -1;
+	return out;
+}
+
+/*
+ * the alternation of the strings in the trie siblings starting at x
+ */
+
+static int
+nfatrie(Dfa_t* dfa, Rex_t* rex, Trie_node_t* x, int out)
+{
+	int	s;
+	int	t;
+	int	r = -1;
+
+	for (; x; x = x->sib)
+	{
+		if (!x->son)
+			t = out;
+		else if ((t = nfatrie(dfa, rex, x->son, out)) < 0 || x->end && (t = nfastate(dfa, N_SPLIT, out, t)) < 0)
+			return -1;
+		if ((s = nfabyte(dfa, rex->map, x->c, t)) < 0 || r >= 0 && (s = nfastate(dfa, N_SPLIT, r, s)) < 0)
+			return -1;
+		r = s;
+	}
+	return r;
+}
+
+/*
+ * NFA for the rex list leading to out
+ */
+
+static int
+nfa(Dfa_t* dfa, Rex_t* rex, int out)
+{
+	unsigned char*	s;
+	int		i;
+	int		l;
+	int		r;
+
+	if (!rex)
+		return out;
+	if ((out = nfa(dfa, rex->next, out)) < 0)
+		return -1;
+	switch (rex->type)
+	{
+	case REX_NULL:
+		return out;
+	case REX_BEG:
+	case REX_END:
+		if ((i = nfastate(dfa, rex->type == REX_BEG ? N_BOL : N_EOL, out, 0)) >= 0 && (rex->flags & REG_NEWLINE))
+			dfa->nfa[i].nl = dfa->nl = 1;
+		return i;
+	case REX_DOT:
+	case REX_CLASS:
+	case REX_COLL_CLASS:
+	case REX_ONECHAR:
+	case REX_REP:
+		return nfarep(dfa, rex, out);
+	case REX_STRING:
+	case REX_KMP:
+		s = rex->re.string.base;
+		for (i = rex->re.string.size; i-- > 0;)
+			if ((out = nfabyte(dfa, rex->map, s[i], out)) < 0)
+				return -1;
+		if (rex->type == REX_KMP)
+		{
+			/* KMP searches from the current position on */
+			if ((r = nfastate(dfa, N_SPLIT, -1, out)) < 0 || !nfaset(dfa) || (l = nfachr(dfa, r)) < 0)
+				return -1;
+			memset(&dfa->sets[dfa->nsets - 1], 0xff, sizeof(Set_t));
+			dfa->nfa[r].out = l;
+			out = r;
+		}
+		return out;
+	case REX_TRIE:
+		r = -1;
+		for (i = 0; i <= UCHAR_MAX; i++)
+			if (rex->re.trie.root[i])
+			{
+				if ((l = nfatrie(dfa, rex, rex->re.trie.root[i], out)) < 0 || r >= 0 && (l = nfastate(dfa, N_SPLIT, r, l)) < 0)
+					return -1;
+				r = l;
+			}
+		return r;
+	case REX_ALT:
+		if ((l = nfa(dfa, rex->re.group.expr.binary.left, out)) < 0 || (r = nfa(dfa, rex->re.group.expr.binary.right, out)) < 0)
+			return -1;
+		return nfastate(dfa, N_SPLIT, l, r);
+	case REX_GROUP:
+		return nfa(dfa, rex->re.group.expr.rex, out);
+	}
+	return -1;
+}
+
+/*
+ * partition the bytes into classes that no N_CHR set distinguishes
+ */
+
+static void
+dfaclass(Dfa_t* dfa)
+{
+	unsigned char	next[UCHAR_MAX+1];
+	short		map[2*(UCHAR_MAX+1)];
+	int		i;
+	int		k;
+	int		c;
+	int		n;
+
+	memset(dfa->class, 0, sizeof(dfa->class));
+	dfa->nclass = 1;
+	for (i = 0; i <= dfa->nsets; i++)
+	{
+		memset(map, -1, sizeof(map));
+		for (n = c = 0; c <= UCHAR_MAX; c++)
+		{
+			k = 2 * dfa->class[c] + (i < dfa->nsets ? settst(&dfa->sets[i], c) != 0 : dfa->nl && c == '\n');
+			if (map[k] < 0)
+				map[k] = n++;
+			next[c] = map[k];
+		}
+		memcpy(dfa->class, next, sizeof(next));
+		dfa->nclass = n;
+	}
+	for (c = UCHAR_MAX; c >= 0; c--)
+		dfa->rep[dfa->class[c]] = c;
+	dfa->nlclass = dfa->nl ? dfa->class['\n'] : -1;
+}
+
+/*
+ * epsilon closure of the n NFA states in dfa->work in context ctx
+ * the sorted N_CHR, N_EOL and N_MATCH states are left in dfa->list
+ * the number of states is returned; *match is set if N_MATCH was reached
+ */
+
+static int
+intcmp(const void* a, const void* b)
+{
+	return *(const int*)a - *(const int*)b;
+}
+
+static int
+closure(Dfa_t* dfa, int n, int ctx, int* match)
+{
+	Nfa_t*	x;
+	int	s;
+	int	m = 0;
+
+	if (!++dfa->gen)
+	{
+		memset(dfa->mark, 0, dfa->nnfa * sizeof(dfa->mark[0]));
+		dfa->gen = 1;
+	}
+	*match = 0;
+	while (n > 0)
+	{
+		s = dfa->work[--n];
+		if (dfa->mark[s] == dfa->gen)
+			continue;
+		dfa->mark[s] = dfa->gen;
+		x = &dfa->nfa[s];
+		switch (x->type)
+		{
+		case N_SPLIT:
+			dfa->work[n++] = x->alt;
+			dfa->work[n++] = x->out;
+			break;
+		case N_BOL:
+			if ((ctx & C_BEG) || x->nl && (ctx & C_NL))
+				dfa->work[n++] = x->out;
+			break;
+		case N_EOL:
+			if ((ctx & C_END) || x->nl && (ctx & C_NLNEXT))
+				dfa->work[n++] = x->out;
+			else
+				dfa->list[m++] = s;
+			break;
+		case N_MATCH:
+			*match = 1;
+			/* FALLTHROUGH */
+		default:
+			dfa->list[m++] = s;
+			break;
+		}
+	}
+	qsort(dfa->list, m, sizeof(dfa->list[0]), intcmp);
+	return m;
+}
+
+/*
+ * free the cached DFA states
+ */
+
+static void
+dfaflush(Dfa_t* dfa)
+{
+	Dstate_t*	d;
+	Dstate_t*	t;
+	int		i;
+
+	for (i = 0; i < DFA_STATES; i++)
+	{
+		for (d = dfa->table[i]; d; d = t)
+		{
+			t = d->link;
+			if (d->skip)
+				free(d->skip);
+			free(d);
+		}
+		dfa->table[i] = 0;
+	}
+	memset(dfa->begin, 0, sizeof(dfa->begin));
+	dfa->count = 0;
+}
+
+/*
+ * the cached DFA state for the n states in dfa->list and ctx
+ * 0 returned on allocation failure
+ */
+
+static Dstate_t*
+dfastate(Dfa_t* dfa, int n, int ctx, int match)
+{
+	Dstate_t*	d;
+	Nfa_t*		x;
+	unsigned int	h;
+	int		i;
+	int		m;
+
+	h = ctx;
+	for (i = 0; i < n; i++)
+		h = h * 31 + dfa->list[i];
+	for (d = dfa->table[h & (DFA_STATES - 1)]; d; d = d->link)
+		if (d->hash == h && d->ctx == ctx && d->nset == n && !memcmp(d->set, dfa->list, n * sizeof(int)))
+			return d;
+	if (dfa->count >= DFA_STATES)
+		dfaflush(dfa);
+	if (!(d = newof(0, Dstate_t, 1, dfa->nclass * sizeof(Dstate_t*) + n * sizeof(int))))
+		return NULL;
+	d->set = (int*)(NEXT(d) + dfa->nclass);
+	d->hash = h;
+	d->ctx = ctx;
+	d->nset = n;
+	memcpy(d->set, dfa->list, n * sizeof(int));
+	d->match = match;
+	d->stop = match || !n;
+	for (i = m = 0; i < n; i++)
+	{
+		x = &dfa->nfa[d->set[i]];
+		if (x->type == N_EOL)
+		{
+			dfa->work[m++] = d->set[i];
+			if (x->nl)
+				d->nleol = 1;
+		}
+	}
+	if (m)
+		closure(dfa, m, ctx|C_END, &i);
+	else
+		i = 0;
+	d->endmatch = match || i;
+	d->link = dfa->table[h & (DFA_STATES - 1)];
+	dfa->table[h & (DFA_STATES - 1)] = d;
+	dfa->count++;
+	return d;
+}
+
+/*
+ * the state after byte class k in state d
+ */
+
+static Dstate_t*
+dfastep(Dfa_t* dfa, Dstate_t* d, int k)
+{
+	Nfa_t*		x;
+	Dstate_t*	t;
+	int*		set;
+	int		c;
+	int		i;
+	int		m;
+	int		n;
+
+	set = d->set;
+	n = d->nset;
+	if (k == dfa->nlclass && d->nleol)
+	{
+		/* a REG_NEWLINE $ matches before the newline */
+		memcpy(dfa->work, set, n * sizeof(int));
+		n = closure(dfa, n, d->ctx|C_NLNEXT, &m);
+		if (m)
+			return NEXT(d)[k] = &dfa->hit;
+		set = dfa->list;
+	}
+	c = dfa->rep[k];
+	for (i = m = 0; i < n; i++)
+	{
+		x = &dfa->nfa[set[i]];
+		if (x->type == N_CHR && settst(&dfa->sets[x->alt], c))
+			dfa->work[m++] = x->out;
+	}
+	n = closure(dfa, m, k == dfa->nlclass ? C_NL : 0, &m);
+	if (dfa->count >= DFA_STATES)
+		d = 0;
+	if (!(t = dfastate(dfa, n, k == dfa->nlclass ? C_NL : 0, m)))
+		return NULL;
+	if (d)
+		NEXT(d)[k] = t;
+	return t;
+}
+
+/*
+ * d has a transition to itself; find the bytes that leave d so that
+ * runs of the others can be skipped without stepping through the DFA
+ */
+
+static void
+dfaskip(Dfa_t* dfa, Dstate_t* d)
+{
+	int	c;
+	int	k;
+
+	d->tried = 1;
+	if (dfa->count + dfa->nclass >= DFA_STATES || !(d->skip = newof(0, unsigned char, UCHAR_MAX + 1, 0)))
+		return;
+	for (k = 0; k < dfa->nclass; k++)
+		if (!NEXT(d)[k] && !dfastep(dfa, d, k))
+		{
+			free(d->skip);
+			d->skip = 0;
+			return;
+		}
+	for (c = 0; c <= UCHAR_MAX; c++)
+		if (NEXT(d)[dfa->class[c]] != d)
+		{
+			d->skip[c] = 1;
+			d->skipc = c;
+			d->nskip++;
+		}
+}
+
+/*
+ * build the NFA for env, 0 if not supported
+ */
+
+static Dfa_t*
+dfaopen(Env_t* env)
+{
+	Dfa_t*	dfa;
+	Rex_t*	rex;
+	int	i;
+	int	m;
+
+	if (env->leading >= 0 || (env->disc->re_flags & REG_NOFREE) || !(dfa = newof(0, Dfa_t, 1, 0)))
+		return NULL;
+	if ((rex = env->rex)->type == REX_BM)
+		rex = rex->next;
+	if ((m = nfastate(dfa, N_MATCH, -1, 0)) < 0 ||
+	    (dfa->start = nfa(dfa, rex, m)) < 0 ||
+	    (dfa->loop = nfastate(dfa, N_SPLIT, -1, dfa->start)) < 0 ||
+	    !nfaset(dfa) ||
+	    (i = nfachr(dfa, dfa->loop)) < 0 ||
+	    !(dfa->work = newof(0, int, 3 * dfa->nnfa, 0)) ||
+	    !(dfa->list = newof(0, int, dfa->nnfa, 0)) ||
+	    !(dfa->mark = newof(0, unsigned int, dfa->nnfa, 0)))
+	{
+		dfa->nnfa = 0;
+		env->dfa = dfa;
+		dfafree(env);
+		return NULL;
+	}
+	memset(&dfa->sets[dfa->nsets - 1], 0xff, sizeof(Set_t));
+	dfa->nfa[dfa->loop].out = i;
+	dfaclass(dfa);
+	dfa->hit.match = dfa->hit.stop = 1;
+	return dfa;
+}
+
+/*
+ * free the DFA for env
+ */
+
+void
+dfafree(Env_t* env)
+{
+	Dfa_t*	dfa;
+
+	if (dfa = env->dfa)
+	{
+		env->dfa = 0;
+		dfaflush(dfa);
+		free(dfa->nfa);
+		free(dfa->sets);
+		free(dfa->work);
+		free(dfa->list);
+		free(dfa->mark);
+		free(dfa);
+	}
+}
+
+/*
+ * match the len bytes at s with env
+ * 0 returned on match, REG_NOMATCH on no match,
+ * -1 if the expression or subject is not supported
+ */
+
+int
+dfaexec(Env_t* env, const unsigned char* s, size_t len, regflags_t flags)
+{
+	Dfa_t*			dfa;
+	Dstate_t*		d;
+	Dstate_t*		t;
+	const unsigned char*	e = s + len;
+	int			b;
+	int			i;
+	int			m;
+	char*			v;
+
+	static int		disabled = -1;
+
+	if (env->nodfa)
+		return -1;
+	if (mbwide())
+	{
+		/* bytes are characters only in the ASCII range */
+		const unsigned char*	u;
+
+		for (u = s; u < e; u++)
+			if (*u & 0x80)
+				return -1;
+	}
+	if (!(dfa = env->dfa))
+	{
+		if (disabled < 0)
+			disabled = (v = getenv("_AST_regex_dfa")) && *v == '0';
+		if (disabled || !(dfa = env->dfa = dfaopen(env)))
+		{
+			env->nodfa = 1;
+			return -1;
+		}
+	}
+	b = ((flags & REG_LEFT) ? 2 : 0) + !(flags & REG_NOTBOL);
+	if (!(d = dfa->begin[b]))
+	{
+		dfa->work[0] = (flags & REG_LEFT) ? dfa->start : dfa->loop;
+		i = closure(dfa, 1, (flags & REG_NOTBOL) ? 0 : C_BEG, &m);
+		if (!(d = dfastate(dfa, i, (flags & REG_NOTBOL) ? 0 : C_BEG, m)))
+			return -1;
+		dfa->begin[b] = d;
+	}
+	if (d->stop)
+		return d->match ? 0 : REG_NOMATCH;
+	for (;;)
+	{
+		if (d->skip)
+		{
+			if (d->nskip > 1)
+				while (s < e && !d->skip[*s])
+					s++;
+			else if (!d->nskip || !(s = memchr(s, d->skipc, e - s)))
+				s = e;
+		}
+		if (s >= e)
+			return d->endmatch && !(flags & REG_NOTEOL) ? 0 : REG_NOMATCH;
+		i = dfa->class[*s++];
+		if (!(t = NEXT(d)[i]) && !(t = dfastep(dfa, d, i)))
+			return -1;
+		if (t->stop)
+			return t->match ? 0 : REG_NOMATCH;
+		if (t == d && !d->tried)
+			dfaskip(dfa, d);
+		d = t;
+	}
+}
@@ -36,6 +36,9 @@
 
 #define alloc		_reg_alloc
 #define classfun	_reg_classfun
+#define collmatch	_reg_collmatch
+#define dfaexec		_reg_dfaexec
+#define dfafree		_reg_dfafree
 #define drop		_reg_drop
 #define fatal		_reg_fatal
 #define state		_reg_state
@@ -543,9 +546,11 @@ typedef struct reglib_s			/* library private regex_t info	*/
 	int		leading;	/* leading match on this char	*/
 	int		refs;		/* regcomp()+regdup() references*/
 	Rex_t		done;		/* the last continuation	*/
+	struct Dfa_s*	dfa;		/* lazy DFA for yes/no matches	*/
 	regstat_t	stats;		/* for regstat()		*/
 	unsigned char	fold[UCHAR_MAX+1]; /* REG_ICASE map		*/
 	unsigned char	hard;		/* hard comp			*/
+	unsigned char	nodfa;		/* no DFA for this expression	*/
 	unsigned char	once;		/* if 1st parse fails, quit	*/
 	unsigned char	separate;	/* cannot combine		*/
 	unsigned char	stack;		/* hard comp or exec		*/
@@ -580,6 +585,9 @@ extern State_t		state;
 
 extern void*		alloc(regdisc_t*, void*, size_t);
 extern regclass_t	classfun(int);
+extern int		collmatch(Rex_t*, unsigned char*, unsigned char*, unsigned char**);
+extern int		dfaexec(Env_t*, const unsigned char*, size_t, regflags_t);
+extern void		dfafree(Env_t*);
 extern void		drop(regdisc_t*, Rex_t*);
 extern int		fatal(regdisc_t*, int, const char*);
 
@@ -100,6 +100,8 @@ static const char* rexname(Rex_t* rex)
 
 #endif
 
+#define DFA_MIN		64	/* min subject length for a new DFA	*/
+
 #define BEG_ALT		1	/* beginning of an alt			*/
 #define BEG_ONE		2	/* beginning of one iteration of a rep	*/
 #define BEG_REP		3	/* beginning of a repetition		*/
@@ -644,7 +646,7 @@ collic(Celt_t* ce, char* key, char* nxt, int c, int x)
 	return collelt(ce, key, c, x);
 }
 
-static int
+int
 collmatch(Rex_t* rex, unsigned char* s, unsigned char* e, unsigned char** p)
 {
 	unsigned char*		t;
@@ -1905,6 +1907,24 @@ regnexec_20120528(const regex_t* p, const char* s, size_t len, size_t nmatch, re
 			advance = 1;
 	}
 	DEBUG_TEST(0x1000,(list(env,env->rex)),(0));
+
+	/*
+	 * the lazy DFA answers yes/no without backtracking; when the match
+	 * offsets are needed it still rules out non-matching subjects
+	 * it is not worth building for short subjects and easy expressions
+	 */
+
+	if ((len >= DFA_MIN || env->hard || env->dfa) && !(flags & REG_ADVANCE) && (k = dfaexec(env, (unsigned char*)s, len, flags)) >= 0)
+	{
+		if (k)
+			goto done;
+		if (!nmatch || (env->flags & REG_NOSUB))
+		{
+			i = BEST;
+			n = env->nsub;
+			goto hit;
+		}
+	}
 	k = REG_NOMATCH;
 	if ((e = env->rex)->type == REX_BM)
 	{
@@ -2048,6 +2068,7 @@ regfree(regex_t* p)
 		if (--env->refs <= 0 && !(env->disc->re_flags & REG_NOFREE))
 		{
 			drop(env->disc, env->rex);
+			dfafree(env);
 			if (env->pos)
 				vecclose(env->pos);
 			if (env->bestpos)
@@ -53,6 +53,7 @@
  */
 
 #include <ast.h>
+#include <lc.h>
 #include <regex.h>
 
 static struct State_s
@@ -61,6 +62,121 @@ static struct State_s
 	int		nmatch;
 } matchstate;
 
+/*
+ * return the first occurrence of p (length m>0) in b (length z) or 0
+ * memmem() is not portable; memchr() and memcmp() do the heavy lifting
+ */
+
+static const char*
+findstr(const char* b, size_t z, const char* p, size_t m)
+{
+	const char*	e;
+
+	if (m > z)
+		return 0;
+	e = b + z - m;
+	while (b <= e && (b = (const char*)memchr(b, *p, e - b + 1)))
+	{
+		if (!memcmp(b + 1, p + 1, m - 1))
+			return b;
+		b++;
+	}
+	return 0;
+}
+
+/*
+ * fast path for patterns that are a literal string with an optional
+ * leading and/or trailing * -- the common case for file name suffixes
+ * and prefixes -- matched with memcmp() instead of regex
+ * -1 returned if the pattern or flags are not handled here
+ * otherwise the match range is set in *so and *eo and 0 or 1 returned
+ */
+
+static int
+fastmatch(const char* b, size_t z, const char* p, int flags, ssize_t* so, ssize_t* eo)
+{
+	const char*	s;
+	size_t		m;
+	int		lead;
+	int		trail;
+	int		c;
+
+	if (flags & (REG_ADVANCE|STR_ICASE))
+		return -1;
+	/*
+	 * in a multibyte locale, ASCII bytes are only guaranteed to
+	 * be whole characters in UTF-8; anything else is left to regex
+	 */
+	if (mbwide() && !(lcinfo(LC_CTYPE)->lc->flags & LC_utf8))
+		return -1;
+	for (lead = 0; *p == '*'; p++)
+		lead = 1;
+	trail = 0;
+	for (s = p; c = *(unsigned char*)s; s++)
+		switch (c)
+		{
+		case '*':
+			/* only a run of trailing stars is OK */
+			for (m = 1; s[m] == '*'; m++);
+			if (s[m])
+				return -1;
+			trail = 1;
+			goto done;
+		case '?': case '[': case ']': case '\\':
+		case '(': case ')': case '|': case '&':
+		case '!': case '@': case '+': case '%':
+		case '{': case '}': case '~': case '^':
+		case '$': case '<': case '>':
+			return -1;
+		default:
+			if (c >= 0x80 && mbwide())
+				return -1;
+			break;
+		}
+ done:
+	m = s - p;
+	switch (flags & (STR_LEFT|STR_RIGHT))
+	{
+	case STR_LEFT|STR_RIGHT:
+		if (m > z)
+			return 0;
+		if (!lead && !trail)
+			c = m == z && !memcmp(b, p, m);
+		else if (!lead)
+			c = !memcmp(b, p, m);
+		else if (!trail)
+			c = !memcmp(b + z - m, p, m);
+		else
+			c = !m || findstr(b, z, p, m) != 0;
+		*so = 0;
+		*eo = z;
+		return c;
+	case STR_LEFT:
+		if (lead || m > z || memcmp(b, p, m))
+			return lead ? -1 : 0;
+		*so = 0;
+		*eo = trail && (flags & STR_MAXIMAL) ? z : m;
+		return 1;
+	case STR_RIGHT:
+		if (lead || trail)
+			return -1;
+		if (m > z || memcmp(b + z - m, p, m))
+			return 0;
+		*so = z - m;
+		*eo = z;
+		return 1;
+	case 0:
+		if (lead || trail)
+			return -1;
+		if (!(s = findstr(b, z, p, m)))
+			return 0;
+		*so = s - b;
+		*eo = *so + m;
+		return 1;
+	}
+	return -1;
+}
+
 /*
  * subgroup match
  * 0 returned if no match
@@ -76,6 +192,8 @@ strngrpmatch(const char* b, size_t z, const char* p, ssize_t* sub, int n, int fl
 {
 	regex_t*	re;
 	ssize_t*	end;
+	ssize_t		so;
+	ssize_t		eo;
 	int		i;
 	regflags_t	reflags;
 
@@ -104,6 +222,25 @@ strngrpmatch(const char* b, size_t z, const char* p, ssize_t* sub, int n, int fl
 		}
 		return *b == 0;
 	}
+	if ((i = fastmatch(b, z, p, flags, &so, &eo)) >= 0)
+	{
+		if (i && sub && n > 0)
+		{
+			if (flags & STR_INT)
+			{
+				int*	subi = (int*)sub;
+
+				subi[0] = so;
+				subi[1] = eo;
+			}
+			else
+			{
+				sub[0] = so;
+				sub[1] = eo;
+			}
+		}
+		return i;
+	}
 
 	/*
 	 * convert flags